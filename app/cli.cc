@@ -20,6 +20,7 @@ namespace modes {
 
 using EmitType = Options::EmitType;
 using Optimization = Options::Optimization;
+using DebugInfoLevel = Options::DebugInfoLevel;
 
 void parse_args(argsVector& args) {
   cl::ParseCommandLineOptions(args.size(), args.data(), "Snowball Compiler", nullptr, nullptr, true);
@@ -49,26 +50,67 @@ void register_build_opts(Options::BuildOptions& options, std::string mode, argsV
   cl::opt<bool> silent("silent", cl::desc("Silent mode"), cl::cat(buildCategory));
   cl::opt<std::string> file("file", cl::desc("File to compile"), cl::cat(buildCategory));
   cl::opt<bool> no_progress("no-progress", cl::desc("Disable progress bar"), cl::cat(buildCategory));
+  cl::opt<std::string> cpu("mcpu", cl::desc("Target CPU to generate code for ('native' for the host CPU)"),
+                           cl::cat(buildCategory));
+  cl::opt<std::string> features("target-features", cl::desc("Target features (e.g. '+avx2,-bmi' or 'native')"),
+                                cl::cat(buildCategory));
+  cl::opt<std::string> profile_generate("profile-generate", cl::ValueOptional,
+                                       cl::desc("Instrument the program to write raw profiles when it runs"),
+                                       cl::value_desc("file"), cl::cat(buildCategory));
+  cl::opt<std::string> profile_use("profile-use", cl::desc("Optimize the program using an indexed profile"),
+                                   cl::value_desc("file"), cl::cat(buildCategory));
+  cl::opt<DebugInfoLevel> debug_info(
+    "debug-info",
+    cl::desc("Debug information to generate"),
+    cl::values(
+      clEnumValN(DebugInfoLevel::DEBUG_INFO_NONE, "none", "No debug information"),
+      clEnumValN(DebugInfoLevel::DEBUG_INFO_LINE_TABLES, "line-tables", "Line tables only (faster to generate)"),
+      clEnumValN(DebugInfoLevel::DEBUG_INFO_FULL, "full", "Full debug information")),
+    cl::init(DebugInfoLevel::DEBUG_INFO_DEFAULT),
+    cl::cat(buildCategory));
+  cl::opt<bool> verify_ir("verify-ir", cl::desc("Verify the generated LLVM IR"), cl::cat(buildCategory));
+  cl::opt<std::string> remarks("remarks", cl::ValueOptional,
+                               cl::desc("Report optimization remarks for the passes matching a regex (all by default)"),
+                               cl::value_desc("filter"), cl::cat(buildCategory));
+  cl::opt<std::string> remarks_output("remarks-output", cl::desc("Serialize the optimization remarks into a file"),
+                                      cl::value_desc("file"), cl::cat(buildCategory));
+  cl::opt<std::string> remarks_format("remarks-format", cl::desc("Format of the remarks file (yaml or bitstream)"),
+                                      cl::init("yaml"), cl::cat(buildCategory));
+  cl::opt<bool> icf("icf", cl::desc("Fold functions with identical code (e.g. equivalent generic instantiations)"),
+                    cl::cat(buildCategory));
+  cl::opt<std::string> size_report("size-report", cl::ValueOptional,
+                                   cl::desc("Report the code size of each function and the generic instantiations "
+                                            "(written as JSON if a file is given)"),
+                                   cl::value_desc("file"), cl::cat(buildCategory));
+  cl::opt<std::string> size_report_sort("size-report-sort", cl::desc("Sort the size report by 'size', 'ir' or 'name'"),
+                                        cl::init("size"), cl::cat(buildCategory));
   cl::alias _silent("s", cl::aliasopt(silent), cl::desc("Alias for -silent"), cl::cat(buildCategory));
   cl::alias _no_progress("np", cl::aliasopt(no_progress), cl::desc("Alias for -no-progress"), cl::cat(buildCategory));
   cl::alias _file("f", cl::aliasopt(file), cl::desc("Alias for -file"), cl::cat(buildCategory));
+  cl::alias _march("march", cl::aliasopt(cpu),
+                   cl::desc("Alias for -mcpu, it only selects the CPU (the target triple doesn't change)"),
+                   cl::cat(buildCategory));
   if (mode == "build") {
     auto test = cl::opt<bool>("test", cl::desc("Builds the project for testing"), cl::cat(buildCategory));
     auto bench = cl::opt<bool>("bench", cl::desc("Builds the project for benchmarking"), cl::cat(buildCategory));
     auto output = cl::opt<std::string>("output", cl::desc("Output file"), cl::cat(buildCategory));
-    auto emit = cl::opt<EmitType>("emit",
-                                  cl::desc("Output type"),
-                                  cl::values(
-                                    clEnumValN(EmitType::EXECUTABLE, "exe", "Executable"),
-                                    clEnumValN(EmitType::OBJECT, "obj", "Object file"),
-                                    clEnumValN(EmitType::LLVM_IR, "llvm-ir", "LLVM IR"),
-                                    clEnumValN(EmitType::ASSEMBLY, "asm", "Assembly"),
-                                    clEnumValN(EmitType::SNOWBALL_IR, "snowball-ir", "Snowball IR")),
-                                  cl::init(EmitType::EXECUTABLE), cl::cat(buildCategory));
+    auto emit = cl::list<EmitType>("emit",
+                                   cl::desc("Output type(s), separated by commas"),
+                                   cl::values(
+                                     clEnumValN(EmitType::EXECUTABLE, "exe", "Executable"),
+                                     clEnumValN(EmitType::OBJECT, "obj", "Object file"),
+                                     clEnumValN(EmitType::LLVM_IR, "llvm-ir", "LLVM IR"),
+                                     clEnumValN(EmitType::LLVM_BC, "llvm-bc", "LLVM bitcode"),
+                                     clEnumValN(EmitType::ASSEMBLY, "asm", "Assembly"),
+                                     clEnumValN(EmitType::SNOWBALL_IR, "snowball-ir", "Snowball IR")),
+                                   cl::CommaSeparated, cl::cat(buildCategory));
+    auto watch = cl::opt<bool>("watch", cl::desc("Keep the compiler running and rebuild on file changes"),
+                               cl::cat(buildCategory));
     cl::alias _test("t", cl::aliasopt(test), cl::desc("Alias for -test"), cl::cat(buildCategory));
     cl::alias _bench("b", cl::aliasopt(bench), cl::desc("Alias for -bench"), cl::cat(buildCategory));
     cl::alias _output("o", cl::aliasopt(output), cl::desc("Alias for -output"), cl::cat(buildCategory));
     cl::alias _emit("e", cl::aliasopt(emit), cl::desc("Alias for -emit"), cl::cat(buildCategory));
+    cl::alias _watch("w", cl::aliasopt(watch), cl::desc("Alias for -watch"), cl::cat(buildCategory));
     parse_args(args);
     options.opt = opt;
     options.silent = silent;
@@ -77,7 +119,24 @@ void register_build_opts(Options::BuildOptions& options, std::string mode, argsV
     options.is_test = test;
     options.is_bench = bench;
     options.output = output;
-    options.emit_type = emit;
+    options.emit_types = std::vector<EmitType>(emit.begin(), emit.end());
+    if (options.emit_types.empty()) options.emit_types.push_back(EmitType::EXECUTABLE);
+    options.emit_type = options.emit_types.front();
+    options.watch = watch;
+    options.target.cpu = cpu;
+    options.target.features = features;
+    options.profile.generate = profile_generate.getNumOccurrences() > 0;
+    options.profile.generateFile = profile_generate;
+    options.profile.use = profile_use;
+    options.debug.info = debug_info;
+    options.debug.verifyIR = verify_ir;
+    options.remarks.filter = remarks.getNumOccurrences() > 0 && remarks.empty() ? std::string(".*") : remarks.getValue();
+    options.remarks.output = remarks_output;
+    options.remarks.format = remarks_format;
+    options.size.icf = icf;
+    options.size.report = size_report.getNumOccurrences() > 0;
+    options.size.reportFile = size_report;
+    options.size.reportSort = size_report_sort;
     return;
   }
   parse_args(args);
@@ -85,6 +144,20 @@ void register_build_opts(Options::BuildOptions& options, std::string mode, argsV
   options.silent = silent;
   options.file = file;
   options.no_progress = no_progress;
+  options.target.cpu = cpu;
+  options.target.features = features;
+  options.profile.generate = profile_generate.getNumOccurrences() > 0;
+  options.profile.generateFile = profile_generate;
+  options.profile.use = profile_use;
+  options.debug.info = debug_info;
+  options.debug.verifyIR = verify_ir;
+  options.remarks.filter = remarks.getNumOccurrences() > 0 && remarks.empty() ? std::string(".*") : remarks.getValue();
+  options.remarks.output = remarks_output;
+  options.remarks.format = remarks_format;
+  options.size.icf = icf;
+  options.size.report = size_report.getNumOccurrences() > 0;
+  options.size.reportFile = size_report;
+  options.size.reportSort = size_report_sort;
 }
 
 void run(Options& opts, argsVector& args) {
@@ -200,6 +273,40 @@ void bench(Options& opts, argsVector& args) {
   opts.bench_opts.no_progress = no_progress;
 }
 
+void check(Options& opts, argsVector& args) {
+  hide_args();
+  cl::OptionCategory checkCategory("Check Options");
+  cl::opt<bool> silent("silent", cl::desc("Silent mode"), cl::cat(checkCategory));
+  cl::opt<bool> no_progress("no-progress", cl::desc("Disable progress bar"), cl::cat(checkCategory));
+  cl::opt<bool> json("json", cl::desc("Print the diagnostics as JSON"), cl::cat(checkCategory));
+  cl::opt<std::string> file("file", cl::desc("File to check"), cl::cat(checkCategory));
+  cl::alias _silent("s", cl::aliasopt(silent), cl::desc("Alias for -silent"), cl::cat(checkCategory));
+  cl::alias _no_progress("np", cl::aliasopt(no_progress), cl::desc("Alias for -no-progress"), cl::cat(checkCategory));
+  cl::alias _file("f", cl::aliasopt(file), cl::desc("Alias for -file"), cl::cat(checkCategory));
+  parse_args(args);
+  opts.check_opts.silent = silent;
+  opts.check_opts.no_progress = no_progress;
+  opts.check_opts.json = json;
+  opts.check_opts.file = file;
+}
+
+void profile(Options& opts, argsVector& args) {
+  hide_args();
+  cl::OptionCategory profileCategory("Profile Options");
+  cl::opt<std::string> action(cl::Positional, cl::desc("<action>"), cl::Required, cl::cat(profileCategory));
+  cl::list<std::string> inputs(cl::Positional, cl::desc("<raw profiles>"), cl::OneOrMore, cl::cat(profileCategory));
+  cl::opt<std::string> output("output", cl::desc("Output profile"), cl::init("default.profdata"),
+                              cl::cat(profileCategory));
+  cl::opt<bool> silent("silent", cl::desc("Silent mode"), cl::cat(profileCategory));
+  cl::alias _output("o", cl::aliasopt(output), cl::desc("Alias for -output"), cl::cat(profileCategory));
+  cl::alias _silent("s", cl::aliasopt(silent), cl::desc("Alias for -silent"), cl::cat(profileCategory));
+  parse_args(args);
+  if (action != "merge") throw SNError(Error::ARGUMENT_ERROR, FMT("Unknown profile action '%s'", action.c_str()));
+  opts.profile_opts.silent = silent;
+  opts.profile_opts.output = output;
+  opts.profile_opts.inputs = std::vector<std::string>(inputs.begin(), inputs.end());
+}
+
 void clean(Options& opts, argsVector& args) {
   hide_args();
   cl::OptionCategory cleanCategory("Clean Options");
@@ -238,6 +345,8 @@ Options CLI::parse() {
     {"docs", {Options::DOCS, cli::modes::docs}},
     {"bench", {Options::BENCH, cli::modes::bench}},
     {"clean", {Options::CLEAN, cli::modes::clean}},
+    {"check", {Options::CHECK, cli::modes::check}},
+    {"profile", {Options::PROFILE, cli::modes::profile}},
   };
   if (mode == "--version" || mode == "-v") {
     std::cout SNOWBALL_PRINT_MESSAGE;
@@ -252,6 +361,8 @@ Options CLI::parse() {
     cl::SubCommand docs("docs", "Generate documentation for a Snowball project");
     cl::SubCommand bench("bench", "Benchmark a Snowball program");
     cl::SubCommand clean("clean", "Clean a Snowball project");
+    cl::SubCommand check("check", "Check a Snowball program for errors without building it");
+    cl::SubCommand profile("profile", "Merge raw profiles for profile guided optimization");
     cli::modes::parse_args(args);
     cl::PrintHelpMessage();
     exit(EXIT_SUCCESS);
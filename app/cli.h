@@ -16,6 +16,7 @@ struct Options {
     LLVM_IR,
     ASSEMBLY,
     SNOWBALL_IR,
+    LLVM_BC,
   };
 
   enum Optimization {
@@ -27,16 +28,74 @@ struct Options {
     OPTIMIZE_Oz = 0x05
   };
 
+  enum DebugInfoLevel {
+    // Full debug info for -O0 builds, none for optimized builds
+    DEBUG_INFO_DEFAULT = 0x00,
+    DEBUG_INFO_NONE = 0x01,
+    DEBUG_INFO_LINE_TABLES = 0x02,
+    DEBUG_INFO_FULL = 0x03
+  };
+
+  struct DebugOptions {
+    DebugInfoLevel info = DEBUG_INFO_DEFAULT;
+    // Run the LLVM verifier on the generated code
+    bool verifyIR = false;
+  };
+
+  struct TargetOptions {
+    // CPU to generate code for ("native" for the host CPU)
+    std::string cpu = "";
+    // Comma separated list of target features (e.g. "+avx2,-bmi")
+    std::string features = "";
+  };
+
+  struct ProfileOptions {
+    // Instrument the program so that running it writes raw profiles
+    bool generate = false;
+    // Name pattern for the raw profiles written by the instrumented program
+    std::string generateFile = "";
+    // Indexed profile (.profdata) used to optimize the program
+    std::string use = "";
+  };
+
+  struct RemarkOptions {
+    // Regex matching the passes to report optimization remarks for (empty to disable)
+    std::string filter = "";
+    // File to serialize the remarks into
+    std::string output = "";
+    // Serialization format for `output` ("yaml" or "bitstream")
+    std::string format = "yaml";
+  };
+
+  struct SizeOptions {
+    // Fold functions with identical code (at the IR level and when linking)
+    bool icf = false;
+    // Print the machine code size of each function and the generic instantiations
+    bool report = false;
+    // Write the report as JSON into this file instead of printing it
+    std::string reportFile = "";
+    // Column the functions are sorted by (size, ir or name)
+    std::string reportSort = "size";
+  };
+
   struct BuildOptions {
     bool is_test = false;
     bool is_bench = false;
     Optimization opt = OPTIMIZE_O1;
     EmitType emit_type = EXECUTABLE;
+    // All of the requested outputs, the first one is also `emit_type`.
+    std::vector<EmitType> emit_types = {EXECUTABLE};
 
     bool silent = false;
     std::string file = "";
     std::string output = "";
     bool no_progress = false;
+    bool watch = false;
+    TargetOptions target;
+    ProfileOptions profile;
+    DebugOptions debug;
+    RemarkOptions remarks;
+    SizeOptions size;
   } build_opts;
 
   struct RunOptions : BuildOptions {
@@ -66,6 +125,21 @@ struct Options {
     bool create_dir = false;
   } init_opts;
 
+  struct CheckOptions {
+    bool silent = false;
+    bool no_progress = false;
+    bool json = false;
+
+    std::string file = "";
+  } check_opts;
+
+  struct ProfileMergeOptions {
+    bool silent = false;
+    std::string output = "default.profdata";
+    // Raw profiles (or directories containing them) to merge
+    std::vector<std::string> inputs;
+  } profile_opts;
+
   struct DocsOptions {
     bool silent = false;
     bool no_progress = false;
@@ -83,6 +157,8 @@ struct Options {
     DOCS,
     BENCH,
     CLEAN,
+    CHECK,
+    PROFILE,
   } command = UNKNOWN;
 };
 
@@ -97,6 +173,8 @@ void test(Options& opts, argsVector& args);
 void init(Options& opts, argsVector& args);
 void docs(Options& opts, argsVector& args);
 void bench(Options& opts, argsVector& args);
+void check(Options& opts, argsVector& args);
+void profile(Options& opts, argsVector& args);
 
 } // namespace modes
 } // namespace cli
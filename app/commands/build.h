@@ -19,6 +19,27 @@ namespace fs = std::filesystem;
 namespace snowball {
 namespace app {
 namespace commands {
+/// @return Every output requested by the build options and its path.
+std::vector<std::pair<app::Options::EmitType, std::string>>
+getOutputs(Compiler* compiler, const app::Options::BuildOptions& p_opts, std::string output) {
+  if (p_opts.emit_types.size() <= 1) return {{p_opts.emit_type, output}};
+  // `output` is the path for the first emit type, the rest of the outputs
+  // share its base name with their own extension.
+  bool isStatic = !compiler->getGlobalContext().isDynamic;
+  auto suffix = os::Driver::getOutputFilename("", p_opts.emit_type, isStatic);
+  auto base = utils::endsWith(output, suffix) ? output.substr(0, output.size() - suffix.size()) : output;
+  std::vector<std::pair<app::Options::EmitType, std::string>> outputs;
+  for (auto type : p_opts.emit_types) {
+    outputs.push_back({type, os::Driver::getOutputFilename(base, type, isStatic)});
+  }
+  return outputs;
+}
+
+/// @brief Write the compiled project into the output requested by the build options.
+int emit(Compiler* compiler, const app::Options::BuildOptions& p_opts, std::string output) {
+  return compiler->emit(getOutputs(compiler, p_opts, output), !p_opts.silent);
+}
+
 int build(app::Options::BuildOptions p_opts) {
   std::string filename = p_opts.file;
   std::string package_name = "file";
@@ -29,6 +50,7 @@ int build(app::Options::BuildOptions p_opts) {
     filename = parsed_config["package"]["main"].value_or<std::string>((fs::current_path() / "src" / "main.sn"));
     package_name = (std::string)(parsed_config["package"]["name"].value_or<std::string>("<anonnimus>"));
     package_version = parsed_config["package"]["version"].value_or<std::string>("<unknown>");
+    p_opts.target = Compiler::getTargetOptions(parsed_config, p_opts.target);
   }
   std::ifstream ifs(filename);
   if (ifs.fail()) {
@@ -41,18 +63,24 @@ int build(app::Options::BuildOptions p_opts) {
   }
   std::string build_type;
   if (p_opts.is_test) { build_type = "test + "; }
-  if (p_opts.emit_type == Options::EmitType::EXECUTABLE) {
-    build_type += "executable";
-  } else if (p_opts.emit_type == Options::EmitType::SNOWBALL_IR) {
-    build_type += "snowball-ir";
-  } else if (p_opts.emit_type == Options::EmitType::LLVM_IR) {
-    build_type += "llvm-ir";
-  } else if (p_opts.emit_type == Options::EmitType::OBJECT) {
-    build_type += "library";
-  } else if (p_opts.emit_type == Options::EmitType::ASSEMBLY) {
-    build_type += "assembly";
-  } else {
-    throw SNError(BUG, FMT("Unhandled emit type for build process ('%i')", p_opts.emit_type));
+  for (size_t i = 0; i < p_opts.emit_types.size(); i++) {
+    auto emit_type = p_opts.emit_types[i];
+    if (i > 0) build_type += ", ";
+    if (emit_type == Options::EmitType::EXECUTABLE) {
+      build_type += "executable";
+    } else if (emit_type == Options::EmitType::SNOWBALL_IR) {
+      build_type += "snowball-ir";
+    } else if (emit_type == Options::EmitType::LLVM_IR) {
+      build_type += "llvm-ir";
+    } else if (emit_type == Options::EmitType::LLVM_BC) {
+      build_type += "llvm-bc";
+    } else if (emit_type == Options::EmitType::OBJECT) {
+      build_type += "library";
+    } else if (emit_type == Options::EmitType::ASSEMBLY) {
+      build_type += "assembly";
+    } else {
+      throw SNError(BUG, FMT("Unhandled emit type for build process ('%i')", emit_type));
+    }
   }
   if (p_opts.opt == Options::Optimization::OPTIMIZE_O0) {
     build_type += " + debug";
@@ -66,11 +94,16 @@ int build(app::Options::BuildOptions p_opts) {
     );
   std::string content((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
   // TODO: check for output
-  Compiler* compiler = new Compiler(content, filename);
+  auto compiler = std::make_unique<Compiler>(content, filename);
   compiler->initialize();
   std::string output = _SNOWBALL_OUT_DEFAULT(package_name, p_opts.emit_type, !compiler->getGlobalContext().isDynamic);
   if (!p_opts.output.empty()) { output = p_opts.output; }
   compiler->setOptimization(p_opts.opt);
+  compiler->setTarget(p_opts.target);
+  compiler->setProfile(p_opts.profile);
+  compiler->setDebug(p_opts.debug);
+  compiler->setRemarks(p_opts.remarks);
+  compiler->setSizeOptions(p_opts.size);
   if (p_opts.is_test) { compiler->enable_tests(); }
   auto start = high_resolution_clock::now();
   compiler->enamblePackageManager(p_opts.file.empty());
@@ -85,18 +118,7 @@ int build(app::Options::BuildOptions p_opts) {
     Logger::message("Generating", FMT("Generating output at `%s%s%s`", BOLD, output.c_str(), RESET));
     Logger::log("");
   }
-  int status;
-  if (p_opts.emit_type == app::Options::EmitType::OBJECT) {
-    status = compiler->emitObject(output, !p_opts.silent);
-  } else if (p_opts.emit_type == app::Options::EmitType::SNOWBALL_IR) {
-    status = compiler->emitSnowballIr(output, !p_opts.silent);
-  } else if (p_opts.emit_type == app::Options::EmitType::LLVM_IR) {
-    status = compiler->emitLLVMIr(output, !p_opts.silent);
-  } else if (p_opts.emit_type == app::Options::EmitType::ASSEMBLY) {
-    status = compiler->emitASM(output, !p_opts.silent);
-  } else {
-    status = compiler->emitBinary(output, !p_opts.silent);
-  }
+  int status = emit(compiler.get(), p_opts, output);
   compiler->cleanup();
   return status;
 }
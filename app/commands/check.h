@@ -0,0 +1,105 @@
+
+#include "cli.h"
+#include "compiler.h"
+#include "errors.h"
+#include "utils/logger.h"
+#include "utils/utils.h"
+#include "vendor/toml.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string>
+
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+#ifndef __SNOWBALL_EXEC_CHECK_CMD_H_
+#define __SNOWBALL_EXEC_CHECK_CMD_H_
+
+namespace snowball {
+namespace app {
+namespace commands {
+
+namespace checker {
+/// @brief Convert a compiler diagnostic into its machine-readable form.
+nlohmann::json diagnosticToJson(const SNError* error) {
+  auto diagnostic = nlohmann::json {
+    {"severity", error->error == Error::WARNING ? "warning" : "error"},
+    {"kind", errors::get_error(error->error)},
+    {"message", error->message},
+  };
+  if (auto nice = dynamic_cast<const errors::NiceError*>(error)) {
+    auto dbg = nice->getDBGInfo();
+    diagnostic["file"] = dbg->getSourceInfo()->getPath();
+    diagnostic["line"] = dbg->line;
+    diagnostic["column"] = dbg->pos.second;
+    diagnostic["width"] = dbg->width;
+    if (!nice->info.info.empty()) diagnostic["info"] = nice->info.info;
+    if (!nice->info.note.empty()) diagnostic["note"] = nice->info.note;
+    if (!nice->info.help.empty()) diagnostic["help"] = nice->info.help;
+    if (auto tail = nice->info.tail) diagnostic["related"] = {diagnosticToJson(tail)};
+  }
+  return diagnostic;
+}
+} // namespace checker
+
+/**
+ * @brief Type check the project without generating any code.
+ *
+ * Only the front end of the compiler is executed, LLVM is never
+ * initialized. Diagnostics can be printed as JSON so that editors and
+ * other tools can consume them.
+ */
+int check(app::Options::CheckOptions p_opts) {
+  std::string filename = p_opts.file;
+  if (p_opts.file.empty()) {
+    toml::parse_result parsed_config = Compiler::getConfiguration();
+    filename = parsed_config["package"]["main"].value_or<std::string>((fs::current_path() / "src" / "main.sn"));
+  }
+  std::ifstream ifs(filename);
+  if (ifs.fail()) {
+    SNError(Error::IO_ERROR,
+            FMT("Package main file not found in snowball "
+                "project! \n\t(searching for: '%s')",
+                filename.c_str()))
+    .print_error();
+    return EXIT_FAILURE;
+  }
+  std::string content((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
+  auto start = high_resolution_clock::now();
+  auto compiler = std::make_unique<Compiler>(content, filename);
+  compiler->initialize();
+  compiler->enamblePackageManager(p_opts.file.empty());
+  try {
+    compiler->check(p_opts.no_progress || p_opts.silent || p_opts.json);
+  } catch (const SNError& error) {
+    if (!p_opts.json) throw;
+    auto result = nlohmann::json {{"success", false}, {"diagnostics", {checker::diagnosticToJson(&error)}}};
+    std::cout << result.dump(2) << std::endl;
+    return EXIT_FAILURE;
+  } catch (const std::vector<SNError*>& errors) {
+    if (!p_opts.json) throw;
+    auto result = nlohmann::json {{"success", false}, {"diagnostics", nlohmann::json::array()}};
+    for (auto& error : errors) result["diagnostics"].push_back(checker::diagnosticToJson(error));
+    std::cout << result.dump(2) << std::endl;
+    return EXIT_FAILURE;
+  }
+  auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+  if (p_opts.json) {
+    auto result = nlohmann::json {{"success", true}, {"diagnostics", nlohmann::json::array()}};
+    result["files"] = nlohmann::json::array();
+    for (auto& file : compiler->getSourceFiles()) result["files"].push_back(file.string());
+    result["time_ms"] = duration;
+    std::cout << result.dump(2) << std::endl;
+  } else if (!p_opts.silent) {
+    Logger::message("Finished", FMT("checking target(s) in %s%ims%s", BOLD, duration, RESET));
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace commands
+} // namespace app
+} // namespace snowball
+
+#endif // __SNOWBALL_EXEC_CHECK_CMD_H_
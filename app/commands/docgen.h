@@ -37,7 +37,7 @@ int docgen(app::Options::DocsOptions p_opts) {
       FMT("%s v%s [%sdocumentation%s]", package_name.c_str(), package_version.c_str(), BOLD, RESET)
     );
   // TODO: check for output
-  auto compiler = new Compiler("<invalid>", "<invalid>");
+  auto compiler = std::make_unique<Compiler>("<invalid>", "<invalid>");
   compiler->initialize();
   auto start = high_resolution_clock::now();
   int status = compiler->emitDocs(folder, baseURL, {.name = package_name, .version = package_version}, p_opts.silent);
@@ -0,0 +1,75 @@
+#include "cli.h"
+#include "errors.h"
+#include "utils/logger.h"
+#include "utils/utils.h"
+
+#include <filesystem>
+#include <llvm/ProfileData/InstrProfReader.h>
+#include <llvm/ProfileData/InstrProfWriter.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+#ifndef __SNOWBALL_EXEC_PROFILE_CMD_H_
+#define __SNOWBALL_EXEC_PROFILE_CMD_H_
+
+namespace snowball {
+namespace app {
+namespace commands {
+
+/**
+ * @brief Merge the raw profiles written by a program built with `--profile-generate`
+ *  into an indexed profile that can be passed to `--profile-use`.
+ *
+ * Directories are searched (non recursively) for `.profraw` files.
+ */
+int profile(app::Options::ProfileMergeOptions p_opts) {
+  std::vector<fs::path> inputs;
+  for (auto& input : p_opts.inputs) {
+    if (!fs::is_directory(input)) {
+      inputs.push_back(input);
+      continue;
+    }
+    for (auto& entry : fs::directory_iterator(input)) {
+      if (entry.path().extension() == ".profraw") inputs.push_back(entry.path());
+    }
+  }
+  if (inputs.empty()) throw SNError(Error::IO_ERROR, "No raw profiles found to merge!");
+  llvm::InstrProfWriter writer;
+  for (auto& input : inputs) {
+    auto buffer = llvm::MemoryBuffer::getFile(input.string());
+    if (!buffer)
+      throw SNError(Error::IO_ERROR, FMT("Could not read profile '%s': %s", input.c_str(), buffer.getError().message().c_str()));
+    auto reader = llvm::InstrProfReader::create(std::move(buffer.get()));
+    if (auto err = reader.takeError())
+      throw SNError(Error::IO_ERROR, FMT("Invalid profile '%s': %s", input.c_str(), llvm::toString(std::move(err)).c_str()));
+    if (auto err = writer.mergeProfileKind(reader.get()->getProfileKind()))
+      throw SNError(Error::IO_ERROR, FMT("Incompatible profile '%s': %s", input.c_str(), llvm::toString(std::move(err)).c_str()));
+    for (auto& record : *reader.get()) {
+      writer.addRecord(std::move(record), 1, [&](llvm::Error err) {
+        Logger::warning(FMT("%s: %s", input.c_str(), llvm::toString(std::move(err)).c_str()));
+      });
+    }
+    if (reader.get()->hasError())
+      throw SNError(Error::IO_ERROR, FMT("Invalid profile '%s': %s", input.c_str(),
+                                         llvm::toString(reader.get()->getError()).c_str()));
+  }
+  std::error_code ec;
+  llvm::raw_fd_ostream output(p_opts.output, ec, llvm::sys::fs::OF_None);
+  if (ec) throw SNError(Error::IO_ERROR, FMT("Could not open file: %s", ec.message().c_str()));
+  if (auto err = writer.write(output))
+    throw SNError(Error::IO_ERROR, FMT("Could not write profile: %s", llvm::toString(std::move(err)).c_str()));
+  if (!p_opts.silent)
+    Logger::success(FMT("Merged %i profile(s) into %s%s%s", (int)inputs.size(), BOLD, p_opts.output.c_str(), RESET));
+  return EXIT_SUCCESS;
+}
+
+} // namespace commands
+} // namespace app
+} // namespace snowball
+
+#endif // __SNOWBALL_EXEC_PROFILE_CMD_H_
@@ -23,6 +23,7 @@ int run(app::Options::RunOptions p_opts) {
                (std::string
                )(parsed_config["package"]["main"].value_or<std::string>((fs::current_path() / "src" / "main.sn"))) :
                p_opts.file;
+    p_opts.target = Compiler::getTargetOptions(parsed_config, p_opts.target);
   }
   std::ifstream ifs(filename);
   if (ifs.fail()) {
@@ -37,13 +38,18 @@ int run(app::Options::RunOptions p_opts) {
   // TODO: check for output
   std::string output =
     fs::current_path() / _SNOWBALL_OUT_DEFAULT("snowball-output", Options::EmitType::EXECUTABLE, false);
-  auto compiler = new Compiler(content, filename);
+  auto compiler = std::make_unique<Compiler>(content, filename);
   compiler->initialize();
   compiler->setOptimization(p_opts.opt);
+  compiler->setTarget(p_opts.target);
+  compiler->setProfile(p_opts.profile);
+  compiler->setDebug(p_opts.debug);
+  compiler->setRemarks(p_opts.remarks);
+  compiler->setSizeOptions(p_opts.size);
   // TODO: false if --no-output is passed
   compiler->enamblePackageManager(p_opts.file.empty());
   compiler->compile(p_opts.no_progress || p_opts.silent);
-  compiler->emitBinary(output, false);
+  compiler->emit({{app::Options::EmitType::EXECUTABLE, output}}, false);
   compiler->cleanup();
   char* args[1024] = {strdup(output.c_str())};
   for (size_t i = 0; i < p_opts.progArgs.size(); i++) {
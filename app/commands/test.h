@@ -47,16 +47,17 @@ int test(app::Options::TestOptions p_opts) {
       "Project",
       FMT("%s v%s [%stest + %s%s]", package_name.c_str(), package_version.c_str(), BOLD, build_type.c_str(), RESET)
     );
-  Compiler* compiler = new Compiler(content, filename);
+  auto compiler = std::make_unique<Compiler>(content, filename);
   compiler->initialize();
   compiler->enable_tests();
   compiler->setOptimization(p_opts.opt);
+  compiler->setTarget(Compiler::getTargetOptions(parsed_config, {}));
   auto start = high_resolution_clock::now();
   compiler->enamblePackageManager(true);
   compiler->compile(p_opts.no_progress || p_opts.silent);
   auto stop = high_resolution_clock::now();
   auto date = std::chrono::system_clock::now();
-  compiler->emitBinary(output, false);
+  compiler->emit({{app::Options::EmitType::EXECUTABLE, output}}, false);
   compiler->cleanup();
   // Get duration. Substart timepoints to
   // get duration. To cast it to proper unit
@@ -0,0 +1,252 @@
+
+#include "cli.h"
+#include "commands/build.h"
+#include "compiler.h"
+#include "errors.h"
+#include "utils/logger.h"
+#include "utils/utils.h"
+#include "vendor/toml.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <string.h>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std::chrono;
+namespace fs = std::filesystem;
+
+#ifndef __SNOWBALL_EXEC_WATCH_CMD_H_
+#define __SNOWBALL_EXEC_WATCH_CMD_H_
+
+namespace snowball {
+namespace app {
+namespace commands {
+
+namespace watcher {
+/// @return A hash of the file contents (0 if it can't be read)
+std::size_t hashFile(const fs::path& path) {
+  std::ifstream ifs(path);
+  if (ifs.fail()) return 0;
+  std::string content((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
+  return std::hash<std::string> {}(content);
+}
+
+/**
+ * @brief Files and the modules that import them, directly or not.
+ * @param dependencies The files imported directly by each file.
+ */
+std::set<fs::path> getDependents(const std::map<fs::path, std::set<fs::path>>& dependencies,
+                                 const std::vector<fs::path>& files) {
+  std::set<fs::path> result(files.begin(), files.end());
+  std::vector<fs::path> pending(files.begin(), files.end());
+  while (!pending.empty()) {
+    auto file = pending.back();
+    pending.pop_back();
+    for (auto& [module, imports] : dependencies) {
+      if (imports.count(file) && result.insert(module).second) pending.push_back(module);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Inotify watcher kept for the whole watch session.
+ *
+ * The parent directories are watched instead of the files themselves because
+ * most editors save by writing a new file and renaming it over the old one.
+ * Events that arrive while a build is running stay queued until the next call
+ * to `waitForChanges`.
+ */
+class Watcher {
+  int fd = -1;
+  std::map<int, fs::path> directories;
+  std::set<fs::path> watched;
+
+ public:
+  Watcher() {
+#ifdef __linux__
+    fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0) throw SNError(Error::IO_ERROR, "Could not initialize inotify for watch mode!");
+#else
+    throw SNError(Error::TODO, "Watch mode is only supported on linux for now!");
+#endif
+  }
+  ~Watcher() {
+#ifdef __linux__
+    if (fd >= 0) close(fd);
+#endif
+  }
+
+  /// @brief Start watching the directories of the files that aren't watched yet
+  void track(const std::map<fs::path, std::size_t>& tracked) {
+#ifdef __linux__
+    for (auto& [file, _] : tracked) {
+      auto dir = file.parent_path();
+      if (!watched.insert(dir).second) continue;
+      int wd = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+      if (wd >= 0) directories[wd] = dir;
+    }
+#endif
+  }
+
+  /**
+   * @brief Block until the contents of one of the tracked files change.
+   * @param tracked The tracked files and the hash of the contents they were
+   *  built with, the hashes of the changed files are updated.
+   * @return The files that changed.
+   */
+  std::vector<fs::path> waitForChanges(std::map<fs::path, std::size_t>& tracked) {
+    std::vector<fs::path> changed;
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[4096];
+    while (changed.empty()) {
+      auto length = read(fd, buffer, sizeof(buffer));
+      if (length < 0 && errno == EINTR) continue;
+      if (length <= 0)
+        throw SNError(Error::IO_ERROR, FMT("Could not read the file events for watch mode: %s", strerror(errno)));
+      for (char* ptr = buffer; ptr < buffer + length;) {
+        auto event = (struct inotify_event*)ptr;
+        ptr += sizeof(struct inotify_event) + event->len;
+        if (event->len == 0) continue;
+        auto dir = directories.find(event->wd);
+        if (dir == directories.end()) continue;
+        auto file = dir->second / event->name;
+        auto item = tracked.find(file);
+        if (item == tracked.end()) continue;
+        auto hash = hashFile(file);
+        if (hash == item->second) continue;
+        item->second = hash;
+        if (std::find(changed.begin(), changed.end(), file) == changed.end()) changed.push_back(file);
+      }
+    }
+#endif
+    return changed;
+  }
+};
+} // namespace watcher
+
+/**
+ * @brief Build the project and keep the compiler resident, rebuilding every time one of
+ *  the files that take part in the compilation changes.
+ *
+ * The package manager only runs for the first build and LLVM is initialized only once
+ * for the whole process. Between builds:
+ *  - Files are only lexed and parsed again if they changed, the rest of the syntax trees
+ *    are kept in a cache shared by every build.
+ *  - The changed files and the modules that import them (directly or not) are
+ *    invalidated. The transformer's IR is whole-program (generics get instantiated
+ *    and functions generated on demand across modules), so the project is transformed
+ *    again on top of the cached syntax trees.
+ *  - The generated LLVM module is hashed and nothing is optimized, written or linked
+ *    if it's the same as the last build (e.g. an edit that only touched comments).
+ */
+int watch(app::Options::BuildOptions p_opts) {
+  std::string filename = p_opts.file;
+  std::string package_name = "file";
+  std::string package_version = "<unknown version>";
+  if (p_opts.file.empty()) {
+    toml::parse_result parsed_config = Compiler::getConfiguration();
+    filename = parsed_config["package"]["main"].value_or<std::string>((fs::current_path() / "src" / "main.sn"));
+    package_name = (std::string)(parsed_config["package"]["name"].value_or<std::string>("<anonnimus>"));
+    package_version = parsed_config["package"]["version"].value_or<std::string>("<unknown>");
+    p_opts.target = Compiler::getTargetOptions(parsed_config, p_opts.target);
+  }
+  if (!p_opts.silent)
+    Logger::message(
+      "Project", FMT("%s v%s [%swatch mode%s]", package_name.c_str(), package_version.c_str(), BOLD, RESET)
+    );
+  watcher::Watcher watcher;
+  auto parseCache = std::make_shared<services::ParseCache>();
+  std::map<fs::path, std::size_t> tracked = {{fs::absolute(filename).lexically_normal(), 0}};
+  std::map<fs::path, std::set<fs::path>> dependencies;
+  std::optional<std::size_t> lastModuleHash = std::nullopt;
+  bool firstBuild = true;
+  while (true) {
+    // The hashes are taken before building: a file saved while the build runs
+    // is seen as changed once it finishes.
+    for (auto& [file, hash] : tracked) hash = watcher::hashFile(file);
+    auto buildStart = fs::file_time_type::clock::now();
+    auto start = high_resolution_clock::now();
+    std::ifstream ifs(filename);
+    std::string content((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
+    auto compiler = std::make_unique<Compiler>(content, filename);
+    compiler->initialize();
+    std::string output = _SNOWBALL_OUT_DEFAULT(package_name, p_opts.emit_type, !compiler->getGlobalContext().isDynamic);
+    if (!p_opts.output.empty()) { output = p_opts.output; }
+    compiler->setOptimization(p_opts.opt);
+    compiler->setTarget(p_opts.target);
+    compiler->setProfile(p_opts.profile);
+    compiler->setDebug(p_opts.debug);
+    compiler->setRemarks(p_opts.remarks);
+    compiler->setSizeOptions(p_opts.size);
+    compiler->setParseCache(parseCache);
+    compiler->skipEmitIfUnchanged(lastModuleHash);
+    compiler->enamblePackageManager(firstBuild && p_opts.file.empty());
+    int status = EXIT_FAILURE;
+    try {
+      compiler->compile(true);
+      status = compiler->emit(getOutputs(compiler.get(), p_opts, output), false);
+    } catch (const SNError& error) {
+      error.print_error();
+    } catch (const std::vector<SNError*>& errors) {
+      for (auto& error : errors) error->print_error();
+    }
+    firstBuild = false;
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    bool changedDuringBuild = false;
+    if (status == EXIT_SUCCESS) {
+      lastModuleHash = compiler->getModuleHash();
+      if (compiler->isUpToDate()) {
+        Logger::message("Up to date", FMT("`%s` (checked in %s%ims%s)", output.c_str(), BOLD, duration, RESET));
+      } else {
+        Logger::message("Rebuilt", FMT("`%s` in %s%ims%s", output.c_str(), BOLD, duration, RESET));
+      }
+      // Only replace the tracked files after a successful build, a failed
+      // build may have stopped before importing every module.
+      dependencies = compiler->getDependencies();
+      for (auto& file : compiler->getSourceFiles()) {
+        auto normalized = file.lexically_normal();
+        if (tracked.count(normalized)) continue;
+        // note: files found by this build weren't hashed before it started
+        tracked[normalized] = watcher::hashFile(normalized);
+        std::error_code ec;
+        if (fs::last_write_time(normalized, ec) >= buildStart && !ec) changedDuringBuild = true;
+      }
+    } else {
+      lastModuleHash = std::nullopt;
+      Logger::message("Failed", FMT("build in %s%ims%s", BOLD, duration, RESET));
+    }
+    watcher.track(tracked);
+    std::vector<fs::path> changed;
+    if (changedDuringBuild) {
+      if (!p_opts.silent) Logger::message("Changed", "files imported by the last build were edited while building");
+    } else {
+      if (!p_opts.silent) Logger::message("Watching", FMT("%i file(s) for changes...", (int)tracked.size()));
+      changed = watcher.waitForChanges(tracked);
+    }
+    auto invalidated = watcher::getDependents(dependencies, changed);
+    for (auto& file : changed) {
+      parseCache->invalidate(file);
+      if (!p_opts.silent) Logger::message("Changed", file.string());
+    }
+    if (!p_opts.silent && invalidated.size() > changed.size())
+      Logger::message("Invalidated", FMT("%i dependent module(s)", (int)(invalidated.size() - changed.size())));
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace commands
+} // namespace app
+} // namespace snowball
+
+#endif // __SNOWBALL_EXEC_WATCH_CMD_H_
@@ -1,10 +1,13 @@
 
 #include "cli.h"
 #include "commands/bench.h"
+#include "commands/check.h"
 #include "commands/build.h"
 #include "commands/init.h"
+#include "commands/profile.h"
 #include "commands/run.h"
 #include "commands/test.h"
+#include "commands/watch.h"
 #include "commands/pm.h"
 #include "commands/docgen.h"
 #include "constants.h"
@@ -37,6 +40,7 @@ int _main(int argc, char** argv) {
     app::Options opts = cli->parse();
     switch (opts.command) {
       case app::Options::BUILD:
+        if (opts.build_opts.watch) return app::commands::watch(opts.build_opts);
         return app::commands::build(opts.build_opts);
       case app::Options::RUN:
         return app::commands::run(opts.run_opts);
@@ -50,6 +54,10 @@ int _main(int argc, char** argv) {
         return app::commands::docgen(opts.docs_opts);
       case app::Options::CLEAN:
         return app::commands::clean();
+      case app::Options::CHECK:
+        return app::commands::check(opts.check_opts);
+      case app::Options::PROFILE:
+        return app::commands::profile(opts.profile_opts);
       default:
         throw SNError(Error::TODO, FMT("Command with type %i not yet supported", opts.command));
     }
@@ -2,9 +2,15 @@
 #include "backtracing.h"
 #include "runtime.h"
 
+#include <unordered_map>
+#include <unwind.h>
+#include <vector>
+
 namespace snowball {
 
 static struct backtrace_state *state = nullptr;
+// Frames (including the inlined ones) already resolved for each program counter
+static std::unordered_map<uintptr_t, std::vector<BacktraceFrame>> symbolCache;
 static std::mutex stateLock;
 
 void backtrace_callback(void *data, const char *msg, int errnum) {
@@ -12,51 +18,61 @@ void backtrace_callback(void *data, const char *msg, int errnum) {
   abort();
 }
 
-int backtrace_full_callback(void *data, uintptr_t pc, const char *filename,
-                                int lineno, const char *function) {
-  auto *bt = ((Backtrace *)data);
-  if (!function || !filename) {
-    bt->push(pc);
-  }
-  bt->push(BacktraceFrame {function, filename, pc, lineno});
-  return (bt->frame_count < SNOWBALL_BACKTRACE_LIMIT) ? 0 : 1;
+int backtrace_pcinfo_callback(void *data, uintptr_t pc, const char *filename,
+                              int lineno, const char *function) {
+  auto *frames = ((std::vector<BacktraceFrame> *)data);
+  frames->push_back(BacktraceFrame {function, filename, pc, lineno});
+  return 0;
 }
 
-void Backtrace::push(BacktraceFrame frame) {
-    if (frame_count >= SNOWBALL_BACKTRACE_LIMIT) {
-        return;
-    }
-
-    if (frame_count == 0) {
-        frames = (BacktraceFrame*) malloc(sizeof(BacktraceFrame) * SNOWBALL_BACKTRACE_LIMIT);
-    } 
+struct UnwindData {
+  Backtrace *backtrace;
+  // Frames left to skip before the ones that are recorded
+  int skip;
+};
+
+_Unwind_Reason_Code unwind_callback(struct _Unwind_Context *context, void *data) {
+  auto *unwind = ((UnwindData *)data);
+  if (unwind->skip > 0) {
+    unwind->skip--;
+    return _URC_NO_REASON;
+  }
+  auto *bt = unwind->backtrace;
+  int ip_before_insn = 0;
+  uintptr_t pc = _Unwind_GetIPInfo(context, &ip_before_insn);
+  // Return addresses point after the call, we want the line of the call
+  if (!ip_before_insn && pc > 0) --pc;
+  bt->push(pc);
+  return (bt->frame_count < SNOWBALL_BACKTRACE_LIMIT) ? _URC_NO_REASON : _URC_END_OF_STACK;
+}
 
-    frames[frame_count++] = frame;
+/// @note It must be called with `stateLock` held
+static const std::vector<BacktraceFrame> &symbolize(uintptr_t pc) {
+  auto cached = symbolCache.find(pc);
+  if (cached != symbolCache.end())
+    return cached->second;
+
+  if (!snowball::state)
+    snowball::state =
+        backtrace_create_state(/*filename=*/nullptr, /*threaded=*/1,
+                                snowball::backtrace_callback, /*data=*/nullptr);
+  auto &frames = symbolCache[pc];
+  backtrace_pcinfo(snowball::state, pc, snowball::backtrace_pcinfo_callback,
+                   snowball::backtrace_callback, &frames);
+  if (frames.empty())
+    frames.push_back(BacktraceFrame {nullptr, nullptr, pc, 0});
+  return frames;
 }
 
-void Backtrace::push(uintptr_t address) {
+void Backtrace::push(uintptr_t pc) {
     if (frame_count >= SNOWBALL_BACKTRACE_LIMIT) {
         return;
     }
 
-    if (frame_count == 0) {
-        frames = (BacktraceFrame*) malloc(sizeof(BacktraceFrame) * SNOWBALL_BACKTRACE_LIMIT);
-    } 
-
-    auto frame = BacktraceFrame {
-        .function = "????",
-        .filename = "<invalid>",
-        .address = address,
-        .lineno = 0
-    };
-    frames[frame_count++] = frame;
-}
-
-void Backtrace::pls_free() {
-    free((void*)frames);
+    pcs[frame_count++] = pc;
 }
 
-void print_backtrace(Backtrace backtrace, std::ostringstream &oss) {
+void print_backtrace(const Backtrace &backtrace, std::ostringstream &oss) {
   if (!(snowball::snowball_flags & SNOWBALL_FLAG_DEBUG)) 
     return;
 
@@ -73,37 +89,30 @@ void print_backtrace(Backtrace backtrace, std::ostringstream &oss) {
       return;
   }
   
+  std::lock_guard<std::mutex> lock(snowball::stateLock);
+  int index = 1;
   for (int i = 1; i < backtrace.frame_count; i++) {
-      BacktraceFrame frame = backtrace.frames[i];
-      if (!frame.function || !frame.filename) {
-          oss << "  (#" << i << "): \e[1;30m[" << (void*)frame.address << "]\e[0m - ????\n";
-          continue;
+      for (auto &frame : symbolize(backtrace.pcs[i])) {
+          if (!frame.function || !frame.filename) {
+              oss << "  (#" << index++ << "): \e[1;30m[" << (void*)frame.address << "]\e[0m - ????\n";
+              continue;
+          }
+          oss << "  (#" << index++ << "): \e[1;30m[" << (void*)frame.address << "]\e[0m - " << demangle(frame.function) << "\n";
+          oss << "\t\tat \e[1;32m" << frame.filename << "\e[1;36m:" << frame.lineno << "\e[0m\n";
       }
-      // TODO: demangle function names
-      oss << "  (#" << i << "): \e[1;30m[" << (void*)frame.address << "]\e[0m - " << frame.function << "\n";
-      oss << "\t\tat \e[1;32m" << frame.filename << "\e[1;36m:" << frame.lineno << "\e[0m\n";
   }
 
   oss << "\e[0m\n"; 
-  //backtrace.pls_free();
 }
 
 void get_backtrace(Backtrace &backtrace) {
-  if (!(snowball::snowball_flags & SNOWBALL_FLAG_DEBUG)) {
-    backtrace = Backtrace();
+  backtrace.frame_count = 0;
+  if (!(snowball::snowball_flags & SNOWBALL_FLAG_DEBUG))
     return;
-  }
 
-  if (!snowball::state) {
-    snowball::stateLock.lock();
-    if (!snowball::state)
-      snowball::state =
-          backtrace_create_state(/*filename=*/nullptr, /*threaded=*/1,
-                                  snowball::backtrace_callback, /*data=*/nullptr);
-    snowball::stateLock.unlock();
-  }
-  backtrace_full(snowball::state, /*skip=*/1, snowball::backtrace_full_callback,
-                  snowball::backtrace_callback, &backtrace);
+  // Only the raw program counters are captured here, see `print_backtrace`
+  UnwindData data = {&backtrace, /*skip=*/1};
+  _Unwind_Backtrace(snowball::unwind_callback, &data);
 }
 
-}
\ No newline at end of file
+}
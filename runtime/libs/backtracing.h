@@ -1,4 +1,3 @@
-
 #include <cstdint>
 #include <cstddef>
 #include <iostream>
@@ -20,15 +19,20 @@ struct BacktraceFrame {
   int32_t lineno;
 };
 
+/**
+ * @brief Raw backtrace of a stack.
+ *
+ * Only the program counters are stored when a backtrace is captured, they
+ * are symbolized when (and if) the backtrace gets printed. This keeps
+ * throwing an exception cheap in debug builds since most of them are
+ * catched and their backtrace is never shown.
+ */
 struct Backtrace {
   public:
-    BacktraceFrame *frames;
-    int32_t frame_count;
+    uintptr_t pcs[SNOWBALL_BACKTRACE_LIMIT];
+    int32_t frame_count = 0;
 
-    void push(BacktraceFrame frame);
-    void push(uintptr_t address);
-
-    void pls_free();
+    void push(uintptr_t pc);
 };
 
 /**
@@ -36,8 +40,12 @@ struct Backtrace {
  * @param backtrace The backtrace to print
  * @note It will only print the backtrace if `SN_BACKTRACE=1` is set
  */
-void print_backtrace(Backtrace backtrace, std::ostringstream &oss);
+void print_backtrace(const Backtrace &backtrace, std::ostringstream &oss);
 
+/**
+ * @brief Capture the program counters of the current stack
+ * @note Nothing is captured if the program is not in debug mode
+ */
 void get_backtrace(Backtrace &backtrace);
 
 } // namespace snowball
@@ -0,0 +1,203 @@
+#include "runtime.h"
+
+#include <cxxabi.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+namespace snowball {
+
+namespace {
+
+#define SN_MANGLE_PREFIX "_ZN$SN"
+
+/**
+ * @brief Parser for the names built by `Func::getMangle` and the
+ *  `getMangledName` of the types.
+ *
+ * A function is mangled as `_ZN$SN<module>` followed by one component per
+ * class it's nested in and its own one: `&<length><name>Cv<id>`. Classes
+ * end with `ClsE` (or list their generics between `ClsGSt` and `ClsE`),
+ * the arguments of the function go between `Sa` and `FnE`.
+ */
+class Demangler {
+  const char *p;
+
+ public:
+  explicit Demangler(const char *name) : p(name) {}
+
+  const char *rest() const { return p; }
+
+  bool consume(const char *text) {
+    size_t length = strlen(text);
+    if (strncmp(p, text, length) != 0) return false;
+    p += length;
+    return true;
+  }
+
+  bool number(size_t &result) {
+    if (*p < '0' || *p > '9') return false;
+    result = 0;
+    while (*p >= '0' && *p <= '9') result = result * 10 + (size_t)(*p++ - '0');
+    return true;
+  }
+
+  void skipDigits() {
+    while (*p >= '0' && *p <= '9') p++;
+  }
+
+  /// @brief `$main.tests` -> `tests`, `@sn.std.thread` -> `std::thread`
+  bool module(std::string &result) {
+    const char *end = strchr(p, '&');
+    if (!end) return false;
+    std::string raw(p, end);
+    p = end;
+    if (raw.compare(0, 4, "@sn.") == 0) raw = raw.substr(4);
+    if (raw.compare(0, 5, "$main") == 0) raw = raw.substr(raw.size() > 5 ? 6 : 5);
+    result.clear();
+    for (size_t i = 0; i < raw.size(); i++) {
+      if (raw[i] == '.') {
+        result += "::";
+      } else {
+        result += raw[i];
+      }
+    }
+    while (result.size() >= 2 && result.compare(result.size() - 2, 2, "::") == 0) result.resize(result.size() - 2);
+    return true;
+  }
+
+  /// @brief `&<length><name>` followed by the id of the function or type
+  bool component(std::string &result) {
+    size_t length;
+    if (!consume("&") || !number(length) || strlen(p) < length) return false;
+    result.assign(p, length);
+    p += length;
+    // note: lambdas are named after the function they are declared in
+    const char *lambda = ".$LmbdF";
+    if (result.size() > strlen(lambda) && result.compare(result.size() - strlen(lambda), strlen(lambda), lambda) == 0)
+      result = result.substr(0, result.size() - strlen(lambda)) + "::{lambda}";
+    if (consume("Cv") || consume("Ev") || consume("I")) {
+      // note: profile guided builds strip the ids, see `stabilizeFunctionNames`
+      skipDigits();
+      return true;
+    }
+    return false;
+  }
+
+  /// @brief Generic arguments (`A<index><type>`) until the `end` tag
+  bool generics(const char *end, std::string &result) {
+    result = "<";
+    bool first = true;
+    while (!consume(end)) {
+      size_t index;
+      std::string type;
+      if (!consume("A") || !number(index) || !this->type(type)) return false;
+      if (!first) result += ", ";
+      result += type;
+      first = false;
+    }
+    result += ">";
+    return true;
+  }
+
+  /// @brief The end of a class, enum or interface component (with its generics)
+  bool typeTail(std::string &generics) {
+    generics.clear();
+    if (consume("ClsGSt")) return this->generics("ClsE", generics);
+    if (consume("EnuGSt")) return this->generics("EnuE", generics);
+    if (consume("IGSt")) return this->generics("IE", generics);
+    return consume("ClsE") || consume("EnuE") || consume("IE");
+  }
+
+  bool type(std::string &result) {
+    size_t length;
+    if (consume("T")) {
+      if (!number(length) || strlen(p) < length) return false;
+      result.assign(p, length);
+      p += length;
+    } else if (consume(SN_MANGLE_PREFIX)) {
+      std::string name, generics;
+      if (!module(result) || !component(name) || !typeTail(generics)) return false;
+      result = (result.empty() ? "" : result + "::") + name + generics;
+    } else if (consume("_FntY.")) {
+      std::string ret, arg;
+      if (!type(ret) || !consume("fAr")) return false;
+      result = "func(";
+      bool first = true;
+      while (!consume("fAe")) {
+        if (consume("VaGv")) {
+          result += first ? "..." : ", ...";
+          continue;
+        }
+        if (!type(arg)) return false;
+        result += (first ? "" : ", ") + arg;
+        first = false;
+      }
+      result += ") => " + ret;
+    } else {
+      return false;
+    }
+    while (true) {
+      if (consume(".p")) {
+        // note: the mangled name doesn't tell `*const` and `*mut` apart
+        result = "*" + result;
+      } else if (consume(".r")) {
+        result = "&" + result;
+      } else {
+        return true;
+      }
+    }
+  }
+
+  /// @return The nice name of the function (empty if it couldn't be parsed)
+  std::string function() {
+    std::string result, name, generics;
+    if (!consume(SN_MANGLE_PREFIX) || !module(result)) return "";
+    while (true) {
+      if (!component(name)) return "";
+      result += (result.empty() ? "" : "::") + name;
+      if (*p != '&') {
+        if (!typeTail(generics)) break;
+        result += generics;
+        // note: a method, the class was the mangled name of its parent
+        if (*p != '&') return "";
+      }
+    }
+    // The arguments aren't part of the nice name, they are only skipped
+    if (!consume("Sa")) return "";
+    while (!consume("FnE")) {
+      size_t index;
+      std::string arg;
+      if (!consume("A") || !number(index) || !type(arg)) return "";
+    }
+    return result;
+  }
+};
+
+} // namespace
+
+std::string demangle(const char *name) {
+  if (!name) return "??";
+  if (strncmp(name, SN_MANGLE_PREFIX, strlen(SN_MANGLE_PREFIX)) == 0) {
+    Demangler demangler(name);
+    auto result = demangler.function();
+    if (result.empty()) return name;
+    // Suffixes added by LLVM (e.g. `.cold.1` or the `.resume` part of a coroutine)
+    return result + demangler.rest();
+  }
+  if (strncmp(name, "_Z", 2) == 0) {
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+      std::string result(demangled);
+      free(demangled);
+      return result;
+    }
+    free(demangled);
+  }
+  return name;
+}
+
+#undef SN_MANGLE_PREFIX
+
+} // namespace snowball
@@ -2,6 +2,7 @@
 // https://github.com/codeplaysoftware/llvm-leg/blob/master/examples/ExceptionDemo/ExceptionDemo.cpp
 //#define DEBUG
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
@@ -51,9 +52,15 @@ extern "C" {
 } // extern "C"
 
 // This is the type of the exception object
+// note: Classes are numbered in pre-order over the class hierarchy (see
+//  `LLVMBuilder::assignClassIds`), so a class and its subclasses have
+//  consecutive ids.
 struct OurExceptionType_t {
-  /// type info type
+  /// type info type (class id)
   int type;
+  /// end of the class id range a catch clause matches (`[type, end)`)
+  /// note: It's only used by the type infos of catch clauses
+  int end;
 };
 
 /**
@@ -102,6 +109,63 @@ const unsigned char ourBaseExcpClassChars[] =
 
 static uint64_t ourBaseExceptionClass = 0;
 
+/// Maximum amount of released exception records kept by each thread
+#define SNOWBALL_EXCEPTION_POOL_LIMIT 16
+/// Records used when the heap can't provide one (e.g. throwing because
+/// we ran out of memory)
+#define SNOWBALL_EMERGENCY_POOL_SIZE 8
+
+/// Free list of exception records released by the current thread. Throwing
+/// in a loop (e.g. a parser backtracking) reuses the same few records
+/// instead of going through malloc/free every time.
+/// @note The `snowball_object` field links the records while they are pooled.
+struct ExceptionPool {
+  OurException *head = nullptr;
+  int size = 0;
+
+  ~ExceptionPool() {
+    while (head) {
+      auto *next = (OurException *)head->snowball_object;
+      free(head);
+      head = next;
+    }
+  }
+};
+
+static thread_local ExceptionPool exceptionPool;
+
+/// The last exception caught by the current thread, kept so it can be
+/// thrown again as the class it was thrown with (see `sn.eh.rethrow`).
+struct CaughtException {
+  void *object = nullptr;
+  int type = 0;
+};
+
+static thread_local CaughtException lastCaught;
+static OurException emergencyPool[SNOWBALL_EMERGENCY_POOL_SIZE];
+static std::atomic<bool> emergencyPoolUsed[SNOWBALL_EMERGENCY_POOL_SIZE];
+
+/// Allocates an exception record, reusing a released one if possible.
+/// @returns an uninitialized exception record
+OurException *allocateOurException() {
+  if (auto *exception = exceptionPool.head) {
+    exceptionPool.head = (OurException *)exception->snowball_object;
+    exceptionPool.size--;
+    return exception;
+  }
+
+  if (auto *exception = (OurException *)malloc(sizeof(OurException)))
+    return exception;
+
+  for (int i = 0; i < SNOWBALL_EMERGENCY_POOL_SIZE; i++) {
+    if (!emergencyPoolUsed[i].exchange(true, std::memory_order_acquire))
+      return &emergencyPool[i];
+  }
+
+  fprintf(stderr, "[snowball internal error]: could not allocate an exception!\n");
+  std::abort();
+}
+
 /// Deletes the true previosly allocated exception whose address
 /// is calculated from the supplied OurBaseException_t::unwindException
 /// member address. Handles (ignores), NULL pointers.
@@ -114,8 +178,17 @@ void deleteOurException(OurUnwindException *expToDelete) {
 
   if (expToDelete &&
       (expToDelete->exception_class == ourBaseExceptionClass)) {
-
-    free(((char*) expToDelete) + ourBaseFromUnwindOffset);
+    auto *exception = (OurException *)(((char*) expToDelete) + ourBaseFromUnwindOffset);
+
+    if (exception >= emergencyPool && exception < emergencyPool + SNOWBALL_EMERGENCY_POOL_SIZE) {
+      emergencyPoolUsed[exception - emergencyPool].store(false, std::memory_order_release);
+    } else if (exceptionPool.size < SNOWBALL_EXCEPTION_POOL_LIMIT) {
+      exception->snowball_object = exceptionPool.head;
+      exceptionPool.head = exception;
+      exceptionPool.size++;
+    } else {
+      free(exception);
+    }
   }
 }
 
@@ -376,7 +449,8 @@ static bool handleActionValue(int64_t *resultAction,
       uintptr_t P = readEncodedPointer(&EntryP, TTypeEncoding);
       struct OurExceptionType_t *ThisClassInfo =
         reinterpret_cast<struct OurExceptionType_t *>(P);
-      if (ThisClassInfo->type == type) {
+      // Matches the catched class and all of its subclasses
+      if (ThisClassInfo->type <= type && type < ThisClassInfo->end) {
         *resultAction = i + 1;
         ret = true;
         break;
@@ -640,6 +714,10 @@ void end_stack(void* exep) {
 
 void throwOurException(void* obj) __asm__("sn.eh.throw");
 void *createOurException(void* obj, int type) __asm__("sn.eh.create");
+void releaseOurException(void* exc) __asm__("sn.eh.release");
+void *caughtObject() __asm__("sn.eh.caught_object");
+int caughtClass() __asm__("sn.eh.caught_class");
+void rethrowOurException(void* obj, int type) __asm__("sn.eh.rethrow");
 _Unwind_Reason_Code ourPersonality(int version,
                                    _Unwind_Action actions,
                                    uint64_t exceptionClass,
@@ -650,8 +728,9 @@ _Unwind_Reason_Code ourPersonality(int version,
 /// of the supplied type info type.
 /// @param type type info type
 void *createOurException(void* obj, int type) {
-  const size_t size = sizeof(OurException);
-  OurException *ret = (OurException*) memset(malloc(size), 0, size);
+  OurException *ret = snowball::allocateOurException();
+  // note: the backtrace doesn't need to be cleared, it's always overwritten
+  memset(&ret->unwindException, 0, sizeof(ret->unwindException));
   ret->type.type = type;
   ret->snowball_object = obj;
   ret->unwindException.exception_class = snowball::ourBaseExceptionClass;
@@ -665,6 +744,41 @@ void *createOurException(void* obj, int type) {
   return(&(ret->unwindException));
 }
 
+/// Gives back the record of an exception once it has been catched, so the
+/// next throw can reuse it. The snowball object is not owned by the record
+/// and stays alive.
+/// @param exc the catched _Unwind_Exception instance
+void releaseOurException(void *exc) {
+  auto *unwind = (OurUnwindException *)exc;
+  if (unwind && unwind->exception_class == snowball::ourBaseExceptionClass) {
+    auto *exception = (OurException *)(((char *)unwind) + snowball::ourBaseFromUnwindOffset);
+    snowball::lastCaught.object = exception->snowball_object;
+    snowball::lastCaught.type = exception->type.type;
+  }
+  snowball::deleteOurException(unwind);
+}
+
+/// @return The object of the last exception caught by the current thread
+/// @note Catch variables only hold a copy of the object, typed as the
+///  class named by the catch clause.
+void *caughtObject() {
+  return snowball::lastCaught.object;
+}
+
+/// @return The class id the last exception caught by the current thread
+///  was thrown with.
+int caughtClass() {
+  return snowball::lastCaught.type;
+}
+
+/// Throws an object again with the class id it was first thrown with, so
+/// the clauses catching one of its subclasses still match.
+/// @param obj the object, as returned by `sn.eh.caught_object`
+/// @param type the class id, as returned by `sn.eh.caught_class`
+void rethrowOurException(void *obj, int type) {
+  throwOurException(createOurException(obj, type));
+}
+
 /// This is the personality function which is embedded (dwarf emitted), in the
 /// dwarf unwind info block. Again see: JITDwarfEmitter.cpp.
 /// See @link http://mentorembedded.github.com/cxx-abi/abi-eh.html @unlink
@@ -0,0 +1,423 @@
+#include "runtime.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif
+
+/// Sockets are plain file descriptors, every call returns -1 and sets
+/// `errno` on failure (`EAGAIN` when a non-blocking call would block).
+int snowball_net_tcp_listen(const char *host, uint16_t port, int backlog) _SN_SYM("sn.net.tcp_listen");
+int snowball_net_tcp_connect(const char *host, uint16_t port) _SN_SYM("sn.net.tcp_connect");
+int snowball_net_udp_bind(const char *host, uint16_t port) _SN_SYM("sn.net.udp_bind");
+int snowball_net_unix_listen(const char *path, int backlog) _SN_SYM("sn.net.unix_listen");
+int snowball_net_unix_connect(const char *path) _SN_SYM("sn.net.unix_connect");
+int snowball_net_accept(int fd) _SN_SYM("sn.net.accept");
+int64_t snowball_net_read(int fd, void *buffer, uint64_t size) _SN_SYM("sn.net.read");
+int64_t snowball_net_write(int fd, const void *buffer, uint64_t size) _SN_SYM("sn.net.write");
+int64_t snowball_net_send_to(int fd, const void *buffer, uint64_t size, const void *address)
+    _SN_SYM("sn.net.send_to");
+int64_t snowball_net_recv_from(int fd, void *buffer, uint64_t size, void *address) _SN_SYM("sn.net.recv_from");
+int snowball_net_shutdown(int fd, int how) _SN_SYM("sn.net.shutdown");
+int snowball_net_close(int fd) _SN_SYM("sn.net.close");
+int snowball_net_local_port(int fd) _SN_SYM("sn.net.local_port");
+int snowball_net_take_error(int fd) _SN_SYM("sn.net.take_error");
+int snowball_net_set_nodelay(int fd, bool enabled) _SN_SYM("sn.net.set_nodelay");
+bool snowball_net_would_block() _SN_SYM("sn.net.would_block");
+
+void *snowball_net_address_new() _SN_SYM("sn.net.address_new");
+bool snowball_net_address_resolve(void *address, const char *host, uint16_t port) _SN_SYM("sn.net.address_resolve");
+int snowball_net_address_port(const void *address) _SN_SYM("sn.net.address_port");
+
+/// Edge-triggered readiness notifications, see `std::net::EventLoop`
+void *snowball_reactor_new() _SN_SYM("sn.reactor.new");
+int snowball_reactor_add(void *reactor, int fd, uint32_t interest, uint64_t token) _SN_SYM("sn.reactor.add");
+int snowball_reactor_modify(void *reactor, int fd, uint32_t interest, uint64_t token) _SN_SYM("sn.reactor.modify");
+int snowball_reactor_remove(void *reactor, int fd) _SN_SYM("sn.reactor.remove");
+int snowball_reactor_timer(void *reactor, uint64_t delay, uint64_t interval, uint64_t token)
+    _SN_SYM("sn.reactor.timer");
+uint64_t snowball_reactor_timer_ack(int fd) _SN_SYM("sn.reactor.timer_ack");
+int snowball_reactor_wait(void *reactor, uint64_t *tokens, uint32_t *events, int max, int timeout)
+    _SN_SYM("sn.reactor.wait");
+void snowball_reactor_destroy(void *reactor) _SN_SYM("sn.reactor.destroy");
+
+namespace snowball {
+
+/// Readiness flags shared with `std::net`
+enum NetEvent : uint32_t {
+  NET_READABLE = 1 << 0,
+  NET_WRITABLE = 1 << 1,
+  NET_HANGUP = 1 << 2,
+  NET_ERROR = 1 << 3,
+};
+
+/// @brief Socket address with its length, opaque to the stdlib
+struct NetAddress {
+  socklen_t length;
+  sockaddr_storage storage;
+};
+
+static bool set_nonblocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+static int open_socket(int family, int type) {
+#ifdef __linux__
+  return socket(family, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+#else
+  int fd = socket(family, type, 0);
+  if (fd == -1) return -1;
+  if (!set_nonblocking(fd)) {
+    close(fd);
+    return -1;
+  }
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+  return fd;
+#endif
+}
+
+static bool resolve(NetAddress *address, const char *host, uint16_t port, int type) {
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = type;
+  hints.ai_flags = AI_NUMERICSERV | AI_ADDRCONFIG | (host && *host ? 0 : AI_PASSIVE);
+  char service[8];
+  snprintf(service, sizeof(service), "%u", (unsigned)port);
+  addrinfo *result = nullptr;
+  if (int error = getaddrinfo(host && *host ? host : nullptr, service, &hints, &result)) {
+    errno = error == EAI_SYSTEM ? errno : EADDRNOTAVAIL;
+    return false;
+  }
+  memcpy(&address->storage, result->ai_addr, result->ai_addrlen);
+  address->length = result->ai_addrlen;
+  freeaddrinfo(result);
+  return true;
+}
+
+static bool unix_address(NetAddress *address, const char *path) {
+  auto *un = reinterpret_cast<sockaddr_un *>(&address->storage);
+  size_t length = strlen(path);
+  if (length >= sizeof(un->sun_path)) {
+    errno = ENAMETOOLONG;
+    return false;
+  }
+  memset(un, 0, sizeof(sockaddr_un));
+  un->sun_family = AF_UNIX;
+  memcpy(un->sun_path, path, length);
+  address->length = (socklen_t)(offsetof(sockaddr_un, sun_path) + length + 1);
+  return true;
+}
+
+static int listen_on(const NetAddress &address, int type, int backlog) {
+  int fd = open_socket(address.storage.ss_family, type);
+  if (fd == -1) return -1;
+  int enabled = 1;
+  if (address.storage.ss_family != AF_UNIX) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+  if (bind(fd, (const sockaddr *)&address.storage, address.length) == -1 ||
+      (type == SOCK_STREAM && listen(fd, backlog) == -1)) {
+    int error = errno;
+    close(fd);
+    errno = error;
+    return -1;
+  }
+  return fd;
+}
+
+/// @note The connection is still being established when this returns,
+///  it's done once the socket becomes writable (see `take_error`).
+static int connect_to(const NetAddress &address) {
+  int fd = open_socket(address.storage.ss_family, SOCK_STREAM);
+  if (fd == -1) return -1;
+  if (connect(fd, (const sockaddr *)&address.storage, address.length) == -1 && errno != EINPROGRESS) {
+    int error = errno;
+    close(fd);
+    errno = error;
+    return -1;
+  }
+  return fd;
+}
+
+#ifdef __linux__
+/**
+ * @brief An epoll instance with the buffer its events are read into.
+ *
+ * Every registration is edge-triggered: an event is only reported when
+ * the state of the descriptor changes, so the handler must read (or
+ * write) until the call would block. That keeps the kernel from
+ * reporting the same ready descriptors on every wait, which is what lets
+ * a single thread serve tens of thousands of connections.
+ */
+struct Reactor {
+  int epoll;
+  int capacity = 0;
+  epoll_event *events = nullptr;
+};
+
+static uint32_t to_epoll(uint32_t interest) {
+  uint32_t events = EPOLLET | EPOLLRDHUP;
+  if (interest & NET_READABLE) events |= EPOLLIN;
+  if (interest & NET_WRITABLE) events |= EPOLLOUT;
+  return events;
+}
+
+static uint32_t from_epoll(uint32_t events) {
+  uint32_t result = 0;
+  if (events & (EPOLLIN | EPOLLPRI)) result |= NET_READABLE;
+  if (events & EPOLLOUT) result |= NET_WRITABLE;
+  if (events & (EPOLLHUP | EPOLLRDHUP)) result |= NET_HANGUP;
+  if (events & EPOLLERR) result |= NET_ERROR;
+  return result;
+}
+
+static int reactor_control(void *reactor, int op, int fd, uint32_t interest, uint64_t token) {
+  epoll_event event = {};
+  event.events = to_epoll(interest);
+  event.data.u64 = token;
+  return epoll_ctl(static_cast<Reactor *>(reactor)->epoll, op, fd, &event);
+}
+#endif
+
+} // namespace snowball
+
+int snowball_net_tcp_listen(const char *host, uint16_t port, int backlog) {
+  snowball::NetAddress address;
+  if (!snowball::resolve(&address, host, port, SOCK_STREAM)) return -1;
+  return snowball::listen_on(address, SOCK_STREAM, backlog);
+}
+
+int snowball_net_tcp_connect(const char *host, uint16_t port) {
+  snowball::NetAddress address;
+  if (!snowball::resolve(&address, host, port, SOCK_STREAM)) return -1;
+  return snowball::connect_to(address);
+}
+
+int snowball_net_udp_bind(const char *host, uint16_t port) {
+  snowball::NetAddress address;
+  if (!snowball::resolve(&address, host, port, SOCK_DGRAM)) return -1;
+  return snowball::listen_on(address, SOCK_DGRAM, 0);
+}
+
+int snowball_net_unix_listen(const char *path, int backlog) {
+  snowball::NetAddress address;
+  if (!snowball::unix_address(&address, path)) return -1;
+  // note: a socket file left by a previous run would make bind fail
+  unlink(path);
+  return snowball::listen_on(address, SOCK_STREAM, backlog);
+}
+
+int snowball_net_unix_connect(const char *path) {
+  snowball::NetAddress address;
+  if (!snowball::unix_address(&address, path)) return -1;
+  return snowball::connect_to(address);
+}
+
+int snowball_net_accept(int fd) {
+  while (true) {
+#ifdef __linux__
+    int client = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+    int client = accept(fd, nullptr, nullptr);
+    if (client != -1 && !snowball::set_nonblocking(client)) {
+      close(client);
+      client = -1;
+    }
+#endif
+    if (client != -1 || errno != EINTR) return client;
+  }
+}
+
+int64_t snowball_net_read(int fd, void *buffer, uint64_t size) {
+  while (true) {
+    ssize_t count = read(fd, buffer, size);
+    if (count != -1 || errno != EINTR) return count;
+  }
+}
+
+int64_t snowball_net_write(int fd, const void *buffer, uint64_t size) {
+  while (true) {
+    // note: writing to a closed connection must fail instead of raising SIGPIPE
+#ifdef MSG_NOSIGNAL
+    ssize_t count = send(fd, buffer, size, MSG_NOSIGNAL);
+    if (count == -1 && errno == ENOTSOCK) count = write(fd, buffer, size);
+#else
+    ssize_t count = write(fd, buffer, size);
+#endif
+    if (count != -1 || errno != EINTR) return count;
+  }
+}
+
+int64_t snowball_net_send_to(int fd, const void *buffer, uint64_t size, const void *address) {
+  auto *to = static_cast<const snowball::NetAddress *>(address);
+  while (true) {
+    ssize_t count = sendto(fd, buffer, size, 0, (const sockaddr *)&to->storage, to->length);
+    if (count != -1 || errno != EINTR) return count;
+  }
+}
+
+int64_t snowball_net_recv_from(int fd, void *buffer, uint64_t size, void *address) {
+  auto *from = static_cast<snowball::NetAddress *>(address);
+  while (true) {
+    from->length = sizeof(from->storage);
+    ssize_t count = recvfrom(fd, buffer, size, 0, (sockaddr *)&from->storage, &from->length);
+    if (count != -1 || errno != EINTR) return count;
+  }
+}
+
+int snowball_net_shutdown(int fd, int how) { return shutdown(fd, how); }
+
+int snowball_net_close(int fd) { return close(fd); }
+
+int snowball_net_local_port(int fd) {
+  sockaddr_storage storage;
+  socklen_t length = sizeof(storage);
+  if (getsockname(fd, (sockaddr *)&storage, &length) == -1) return -1;
+  snowball::NetAddress address = {length, storage};
+  return snowball_net_address_port(&address);
+}
+
+int snowball_net_take_error(int fd) {
+  int error = 0;
+  socklen_t length = sizeof(error);
+  if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == -1) return errno;
+  return error;
+}
+
+int snowball_net_set_nodelay(int fd, bool enabled) {
+  int value = enabled;
+  return setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+}
+
+/// @return Whether the last call failed only because the socket wasn't ready
+bool snowball_net_would_block() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS; }
+
+void *snowball_net_address_new() {
+  auto *address = (snowball::NetAddress *)calloc(1, sizeof(snowball::NetAddress));
+  if (address) address->length = sizeof(address->storage);
+  return address;
+}
+
+bool snowball_net_address_resolve(void *address, const char *host, uint16_t port) {
+  return snowball::resolve(static_cast<snowball::NetAddress *>(address), host, port, SOCK_DGRAM);
+}
+
+int snowball_net_address_port(const void *address) {
+  auto *storage = &static_cast<const snowball::NetAddress *>(address)->storage;
+  switch (storage->ss_family) {
+    case AF_INET: return ntohs(reinterpret_cast<const sockaddr_in *>(storage)->sin_port);
+    case AF_INET6: return ntohs(reinterpret_cast<const sockaddr_in6 *>(storage)->sin6_port);
+    default: return -1;
+  }
+}
+
+#ifdef __linux__
+
+void *snowball_reactor_new() {
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll == -1) return nullptr;
+  auto *reactor = new snowball::Reactor();
+  reactor->epoll = epoll;
+  return reactor;
+}
+
+int snowball_reactor_add(void *reactor, int fd, uint32_t interest, uint64_t token) {
+  return snowball::reactor_control(reactor, EPOLL_CTL_ADD, fd, interest, token);
+}
+
+int snowball_reactor_modify(void *reactor, int fd, uint32_t interest, uint64_t token) {
+  return snowball::reactor_control(reactor, EPOLL_CTL_MOD, fd, interest, token);
+}
+
+int snowball_reactor_remove(void *reactor, int fd) {
+  return epoll_ctl(static_cast<snowball::Reactor *>(reactor)->epoll, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+/// @return The timer descriptor, it becomes readable when the timer expires
+int snowball_reactor_timer(void *reactor, uint64_t delay, uint64_t interval, uint64_t token) {
+  int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd == -1) return -1;
+  itimerspec spec = {};
+  // note: a zero delay would disarm the timer
+  if (delay == 0) delay = 1;
+  spec.it_value.tv_sec = delay / 1000000000;
+  spec.it_value.tv_nsec = delay % 1000000000;
+  spec.it_interval.tv_sec = interval / 1000000000;
+  spec.it_interval.tv_nsec = interval % 1000000000;
+  if (timerfd_settime(fd, 0, &spec, nullptr) == -1 ||
+      snowball::reactor_control(reactor, EPOLL_CTL_ADD, fd, snowball::NET_READABLE, token) == -1) {
+    int error = errno;
+    close(fd);
+    errno = error;
+    return -1;
+  }
+  return fd;
+}
+
+/// @return How many times the timer expired since the last call
+uint64_t snowball_reactor_timer_ack(int fd) {
+  uint64_t expirations = 0;
+  if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) return 0;
+  return expirations;
+}
+
+/**
+ * @brief Wait for events, reading up to `max` of them at once.
+ * @param timeout Milliseconds to wait for, -1 waits until something happens.
+ * @return The amount of events written to `tokens` and `events`.
+ */
+int snowball_reactor_wait(void *reactor, uint64_t *tokens, uint32_t *events, int max, int timeout) {
+  auto *r = static_cast<snowball::Reactor *>(reactor);
+  if (r->capacity < max) {
+    delete[] r->events;
+    r->events = new epoll_event[max];
+    r->capacity = max;
+  }
+  int count;
+  do {
+    count = epoll_wait(r->epoll, r->events, max, timeout);
+  } while (count == -1 && errno == EINTR);
+  for (int i = 0; i < count; i++) {
+    tokens[i] = r->events[i].data.u64;
+    events[i] = snowball::from_epoll(r->events[i].events);
+  }
+  return count;
+}
+
+void snowball_reactor_destroy(void *reactor) {
+  auto *r = static_cast<snowball::Reactor *>(reactor);
+  close(r->epoll);
+  delete[] r->events;
+  delete r;
+}
+
+#else
+
+// note: the reactor is only implemented with epoll, on other platforms the
+//  sockets work but creating an event loop fails with ENOSYS.
+void *snowball_reactor_new() {
+  errno = ENOSYS;
+  return nullptr;
+}
+int snowball_reactor_add(void *, int, uint32_t, uint64_t) { return errno = ENOSYS, -1; }
+int snowball_reactor_modify(void *, int, uint32_t, uint64_t) { return errno = ENOSYS, -1; }
+int snowball_reactor_remove(void *, int) { return errno = ENOSYS, -1; }
+int snowball_reactor_timer(void *, uint64_t, uint64_t, uint64_t) { return errno = ENOSYS, -1; }
+uint64_t snowball_reactor_timer_ack(int) { return 0; }
+int snowball_reactor_wait(void *, uint64_t *, uint32_t *, int, int) { return errno = ENOSYS, -1; }
+void snowball_reactor_destroy(void *) {}
+
+#endif
@@ -0,0 +1,247 @@
+#include "runtime.h"
+#include "backtracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <unwind.h>
+#include <vector>
+
+#define SNOWBALL_PROFILE_DEPTH 64
+#define SNOWBALL_PROFILE_HZ 997 // prime, so it doesn't tick in lockstep with periodic work
+#define SNOWBALL_PROFILE_TOP 20
+// Words reserved for the samples (1 GiB of address space, only the pages
+// touched by the samples are actually backed by memory).
+#define SNOWBALL_PROFILE_BUFFER_WORDS (size_t(1) << 27)
+
+namespace snowball {
+
+/**
+ * @brief Sampling CPU profiler, enabled with `SN_PROFILE=<output file>`.
+ *
+ * A `SIGPROF` timer interrupts whatever thread is using the CPU and the
+ * handler copies the program counters of its stack into a preallocated
+ * buffer. Nothing is allocated nor locked from the handler: every sample
+ * reserves its words (`[depth, pc...]`) with a single atomic add and it's
+ * dropped if the buffer is full. The samples are only symbolized when the
+ * program exits, where they are written in the collapsed stack format
+ * (`main;foo;bar 42`, as read by `flamegraph.pl`) and a table of the
+ * hottest functions is printed to stderr.
+ *
+ * `SN_PROFILE_HZ` changes the sampling frequency and `SN_PROFILE_TOP` the
+ * number of functions shown in the table.
+ */
+namespace profiler {
+
+static uintptr_t *buffer = nullptr;
+static std::atomic<size_t> cursor {0};
+static std::atomic<size_t> dropped {0};
+static std::atomic<bool> active {false};
+static const char *output = nullptr;
+static long frequency = SNOWBALL_PROFILE_HZ;
+// CPU time of the process when profiling started
+static double startTime = 0;
+
+static double cpu_seconds() {
+  struct timespec now;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+struct Stack {
+  uintptr_t pcs[SNOWBALL_PROFILE_DEPTH];
+  size_t depth;
+  // Frames of the signal handler and the signal trampoline
+  int skip;
+};
+
+static _Unwind_Reason_Code unwind_callback(struct _Unwind_Context *context, void *data) {
+  auto *stack = ((Stack *)data);
+  if (stack->skip > 0) {
+    stack->skip--;
+    return _URC_NO_REASON;
+  }
+  int ip_before_insn = 0;
+  uintptr_t pc = _Unwind_GetIPInfo(context, &ip_before_insn);
+  if (pc == 0) return _URC_END_OF_STACK;
+  // Return addresses point after the call, we want the line of the call
+  if (!ip_before_insn) --pc;
+  stack->pcs[stack->depth++] = pc;
+  return (stack->depth < SNOWBALL_PROFILE_DEPTH) ? _URC_NO_REASON : _URC_END_OF_STACK;
+}
+
+static void sample(int signal) {
+  if (!active.load(std::memory_order_relaxed)) return;
+  int savedErrno = errno;
+  Stack stack;
+  stack.depth = 0;
+  stack.skip = 2;
+  _Unwind_Backtrace(unwind_callback, &stack);
+  if (stack.depth > 0) {
+    size_t start = cursor.fetch_add(stack.depth + 1, std::memory_order_relaxed);
+    if (start + stack.depth + 1 > SNOWBALL_PROFILE_BUFFER_WORDS) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      buffer[start] = stack.depth;
+      memcpy(&buffer[start + 1], stack.pcs, stack.depth * sizeof(uintptr_t));
+    }
+  }
+  errno = savedErrno;
+}
+
+static void set_timer(long hz) {
+  struct itimerval timer;
+  memset(&timer, 0, sizeof(timer));
+  if (hz > 0) {
+    long interval = 1000000 / hz;
+    timer.it_interval.tv_sec = interval / 1000000;
+    timer.it_interval.tv_usec = interval % 1000000;
+    timer.it_value = timer.it_interval;
+  }
+  setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+static void error_callback(void *data, const char *msg, int errnum) {
+  // note: missing debug info isn't fatal, the symbol table is used instead
+}
+
+static int pcinfo_callback(void *data, uintptr_t pc, const char *filename, int lineno, const char *function) {
+  if (function) ((std::vector<std::string> *)data)->push_back(demangle(function));
+  return 0;
+}
+
+static void syminfo_callback(void *data, uintptr_t pc, const char *symname, uintptr_t symval, uintptr_t symsize) {
+  if (symname) ((std::vector<std::string> *)data)->push_back(demangle(symname));
+}
+
+/// @return Names of the functions at `pc`, the inlined ones first
+static const std::vector<std::string> &symbolize(struct backtrace_state *state, uintptr_t pc) {
+  static std::unordered_map<uintptr_t, std::vector<std::string>> cache;
+  auto cached = cache.find(pc);
+  if (cached != cache.end()) return cached->second;
+  auto &names = cache[pc];
+  if (state) {
+    backtrace_pcinfo(state, pc, pcinfo_callback, error_callback, &names);
+    if (names.empty()) backtrace_syminfo(state, pc, syminfo_callback, error_callback, &names);
+  }
+  if (names.empty()) {
+    char address[32];
+    snprintf(address, sizeof(address), "[%p]", (void *)pc);
+    names.push_back(address);
+  }
+  return names;
+}
+
+static void report() {
+  active.store(false);
+  set_timer(0);
+
+  auto state = backtrace_create_state(/*filename=*/nullptr, /*threaded=*/0, error_callback, /*data=*/nullptr);
+  size_t end = std::min(cursor.load(), SNOWBALL_PROFILE_BUFFER_WORDS);
+  std::unordered_map<std::string, size_t> stacks;
+  std::unordered_map<std::string, size_t> self;
+  std::unordered_map<std::string, size_t> total;
+  std::unordered_set<std::string> seen;
+  std::vector<std::string> frames;
+  size_t samples = 0;
+  for (size_t i = 0; i < end;) {
+    size_t depth = buffer[i];
+    // note: a sample that was dropped for being too big, nothing follows it
+    if (depth == 0 || i + depth + 1 > end) break;
+    frames.clear();
+    for (size_t j = 0; j < depth; j++) {
+      auto &names = symbolize(state, buffer[i + 1 + j]);
+      frames.insert(frames.end(), names.begin(), names.end());
+    }
+    i += depth + 1;
+    samples++;
+
+    std::string folded;
+    for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame) {
+      if (!folded.empty()) folded += ";";
+      folded += *frame;
+    }
+    stacks[folded]++;
+    self[frames.front()]++;
+    // Recursive functions only count once for every sample
+    seen.clear();
+    for (auto &frame : frames)
+      if (seen.insert(frame).second) total[frame]++;
+  }
+
+  FILE *file = fopen(output, "w");
+  if (!file) {
+    fprintf(stderr, "[snowball profiler]: couldn't open `%s`: %s\n", output, strerror(errno));
+  } else {
+    for (auto &[stack, count] : stacks) fprintf(file, "%s %zu\n", stack.c_str(), count);
+    fclose(file);
+  }
+
+  std::vector<std::pair<std::string, size_t>> hottest(self.begin(), self.end());
+  std::sort(hottest.begin(), hottest.end(), [](auto &a, auto &b) { return a.second > b.second; });
+  size_t top = SNOWBALL_PROFILE_TOP;
+  if (auto env = getenv("SN_PROFILE_TOP")) top = strtoul(env, nullptr, 10);
+  if (hottest.size() > top) hottest.resize(top);
+
+  // note: the kernel may deliver fewer signals than requested (its timers are
+  //  only checked on every scheduler tick), the real rate is shown instead
+  double elapsed = cpu_seconds() - startTime;
+  fprintf(stderr, "\n\033[1mProfile:\033[0m %zu samples over %.3fs of CPU (%.0f per second)", samples, elapsed,
+          elapsed > 0 ? (double)samples / elapsed : 0.0);
+  if (dropped.load() > 0) fprintf(stderr, ", %zu dropped", dropped.load());
+  fprintf(stderr, ", written to `%s`\n", output);
+  if (samples == 0) return;
+  fprintf(stderr, "\033[1m%8s %8s  %s\033[0m\n", "self", "total", "function");
+  for (auto &[function, count] : hottest) {
+    fprintf(stderr, "%7.2f%% %7.2f%%  %s\n", 100.0 * count / samples, 100.0 * total[function] / samples,
+            function.c_str());
+  }
+}
+
+} // namespace profiler
+
+void initialize_profiler() {
+  using namespace profiler;
+  output = getenv("SN_PROFILE");
+  if (!output || !*output) return;
+  if (auto env = getenv("SN_PROFILE_HZ")) frequency = strtol(env, nullptr, 10);
+  if (frequency <= 0 || frequency > 1000000) frequency = SNOWBALL_PROFILE_HZ;
+
+  void *memory = mmap(nullptr, SNOWBALL_PROFILE_BUFFER_WORDS * sizeof(uintptr_t), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (memory == MAP_FAILED) {
+    fprintf(stderr, "[snowball profiler]: couldn't allocate the sample buffer: %s\n", strerror(errno));
+    return;
+  }
+  buffer = (uintptr_t *)memory;
+
+  // The unwinder loads and caches its tables on first use, which isn't
+  // safe to do from a signal handler
+  Stack warmup;
+  warmup.depth = 0;
+  warmup.skip = 0;
+  _Unwind_Backtrace(unwind_callback, &warmup);
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(struct sigaction));
+  sigemptyset(&sa.sa_mask);
+  sa.sa_handler = sample;
+  sa.sa_flags = SA_RESTART;
+  sigaction(SIGPROF, &sa, NULL);
+
+  atexit(report);
+  startTime = cpu_seconds();
+  active.store(true);
+  set_timer(frequency);
+}
+
+} // namespace snowball
@@ -5,6 +5,7 @@
 void initialize_snowball(int flags) {
     snowball::initialize_segfault_handler();
     snowball::initialize_exceptions();
+    snowball::initialize_profiler();
 
     snowball::snowball_flags = flags;
 }
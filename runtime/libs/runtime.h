@@ -14,6 +14,10 @@ extern int snowball_flags;
 
 void initialize_exceptions();
 void initialize_segfault_handler();
+void initialize_profiler();
+
+/// @return The nice name (e.g. `std::Vector<i32>::push`) of a mangled function name
+std::string demangle(const char *name);
 
 void error_log(std::ostringstream& oss, const char *message);
 }
@@ -0,0 +1,283 @@
+#include "runtime.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <stdint.h>
+#include <stdlib.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/// Body of every task spawned by `std::task`, see `sn.thread.run`
+void snowball_task_run(void *data) _SN_SYM("sn.task.run") __attribute__((weak));
+
+bool snowball_task_spawn(void *data) _SN_SYM("sn.task.spawn");
+void snowball_task_wait(int32_t *done) _SN_SYM("sn.task.wait");
+uint32_t snowball_task_workers() _SN_SYM("sn.task.workers");
+
+namespace snowball {
+
+/**
+ * @brief Chase-Lev work-stealing deque.
+ *
+ * The owner pushes and pops at the bottom, other workers steal from the
+ * top. Only stealing (and popping the last task) needs a compare-exchange.
+ * @see "Correct and Efficient Work-Stealing for Weak Memory Models"
+ *  (Lê et al., 2013) for the orderings used here.
+ */
+class TaskDeque {
+  struct Buffer {
+    int64_t capacity;
+    std::atomic<void *> *tasks;
+
+    explicit Buffer(int64_t capacity)
+        : capacity(capacity), tasks(new std::atomic<void *>[capacity]) {}
+    ~Buffer() { delete[] tasks; }
+
+    void *get(int64_t i) { return tasks[i & (capacity - 1)].load(std::memory_order_relaxed); }
+    void put(int64_t i, void *task) { tasks[i & (capacity - 1)].store(task, std::memory_order_relaxed); }
+  };
+
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  std::atomic<Buffer *> buffer;
+  // Buffers replaced by a bigger one, thieves may still be reading them
+  std::vector<Buffer *> retired;
+
+ public:
+  TaskDeque() : buffer(new Buffer(256)) {}
+  ~TaskDeque() {
+    delete buffer.load();
+    for (auto *old : retired) delete old;
+  }
+
+  /// @note Only called by the owner
+  void push(void *task) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    auto *buf = buffer.load(std::memory_order_relaxed);
+    if (b - t > buf->capacity - 1) {
+      auto *bigger = new Buffer(buf->capacity * 2);
+      for (int64_t i = t; i < b; i++) bigger->put(i, buf->get(i));
+      retired.push_back(buf);
+      buffer.store(bigger, std::memory_order_release);
+      buf = bigger;
+    }
+    buf->put(b, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /// @note Only called by the owner
+  void *pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    auto *buf = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    void *task = buf->get(b);
+    if (t == b) {
+      // Last task, race with the thieves for it
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        task = nullptr;
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  void *steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+    auto *buf = buffer.load(std::memory_order_consume);
+    void *task = buf->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return nullptr;
+    return task;
+  }
+};
+
+/**
+ * @brief Work-stealing thread pool running the tasks of `std::task`.
+ *
+ * Every worker owns a deque: tasks spawned by a worker go to its own
+ * deque and idle workers steal from the others. Tasks spawned from any
+ * other thread go through a shared queue. It's created the first time a
+ * task is spawned, with one worker per online CPU (or `SN_TASK_THREADS`).
+ * @note The pool is never destroyed, workers sleep while there's nothing
+ *  to do and return when the process exits.
+ */
+class TaskPool {
+  std::vector<TaskDeque *> deques;
+  std::mutex injectorLock;
+  std::deque<void *> injector;
+  // Idle workers and threads joining a task block on `wakeUp`, they are
+  // woken up when a task is submitted, when one finishes and on shutdown.
+  std::mutex sleepLock;
+  std::condition_variable wakeUp;
+  std::atomic<int> sleeping{0};
+  std::atomic<int64_t> pending{0};
+  std::atomic<bool> stopping{false};
+
+  static thread_local int workerIndex;
+
+ public:
+  explicit TaskPool(unsigned count) {
+    for (unsigned i = 0; i < count; i++) deques.push_back(new TaskDeque());
+    for (unsigned i = 0; i < count; i++) std::thread([this, i] { work((int)i); }).detach();
+  }
+
+  static TaskPool &get() {
+    static TaskPool *pool = [] {
+      auto *pool = new TaskPool(defaultWorkers());
+      atexit([] { get().shutdown(); });
+      return pool;
+    }();
+    return *pool;
+  }
+
+  static unsigned defaultWorkers() {
+    if (auto *env = getenv("SN_TASK_THREADS")) {
+      int count = atoi(env);
+      if (count > 0) return (unsigned)count;
+    }
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (unsigned)count : 1;
+  }
+
+  unsigned size() const { return (unsigned)deques.size(); }
+
+  void submit(void *task) {
+    pending.fetch_add(1, std::memory_order_seq_cst);
+    if (workerIndex >= 0) {
+      deques[workerIndex]->push(task);
+    } else {
+      std::lock_guard<std::mutex> lock(injectorLock);
+      injector.push_back(task);
+    }
+    notifySleepers();
+  }
+
+  /// @return A task to run (nullptr if there's nothing to do)
+  void *find() {
+    if (workerIndex >= 0) {
+      if (void *task = deques[workerIndex]->pop()) return task;
+    }
+    if (pending.load(std::memory_order_acquire) == 0) return nullptr;
+    {
+      std::lock_guard<std::mutex> lock(injectorLock);
+      if (!injector.empty()) {
+        void *task = injector.front();
+        injector.pop_front();
+        return task;
+      }
+    }
+    // Start stealing from a different victim on every worker
+    unsigned count = size();
+    unsigned start = workerIndex >= 0 ? (unsigned)workerIndex + 1 : 0;
+    for (unsigned i = 0; i < count; i++) {
+      unsigned victim = (start + i) % count;
+      if ((int)victim == workerIndex) continue;
+      if (void *task = deques[victim]->steal()) return task;
+    }
+    return nullptr;
+  }
+
+  void run(void *task) {
+    pending.fetch_sub(1, std::memory_order_seq_cst);
+    snowball_task_run(task);
+    // Someone may be joining this task
+    notifySleepers();
+  }
+
+  /**
+   * @brief Run tasks until `done` is set, blocking when there's nothing to
+   *  run. Joining from a worker keeps it busy with other tasks meanwhile.
+   */
+  void wait(std::atomic<int32_t> *done) {
+    int idle = 0;
+    while (!done->load(std::memory_order_acquire)) {
+      if (void *task = find()) {
+        run(task);
+        idle = 0;
+      } else if (++idle < 64) {
+        std::this_thread::yield();
+      } else {
+        sleep([this, done] { return done->load(std::memory_order_acquire) || hasWork(); });
+        idle = 0;
+      }
+    }
+  }
+
+  /// @brief Let the workers return once they run out of tasks
+  void shutdown() {
+    stopping.store(true, std::memory_order_seq_cst);
+    std::lock_guard<std::mutex> lock(sleepLock);
+    wakeUp.notify_all();
+  }
+
+ private:
+  bool hasWork() { return pending.load(std::memory_order_seq_cst) > 0; }
+
+  /// @brief Block until `ready` returns true (it's checked every time a
+  ///  task is submitted or finishes).
+  template <typename Ready> void sleep(Ready ready) {
+    std::unique_lock<std::mutex> lock(sleepLock);
+    // note: pairs with the seq_cst operations in `submit`/`run` followed by
+    //  `notifySleepers`, either they see us sleeping or we see their change.
+    sleeping.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeUp.wait(lock, ready);
+    sleeping.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  void notifySleepers() {
+    // note: `done` is stored by the task with release ordering only
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst) == 0) return;
+    // Taking the lock makes sure that a thread that just checked its
+    // condition is already waiting (and gets woken up).
+    std::lock_guard<std::mutex> lock(sleepLock);
+    wakeUp.notify_all();
+  }
+
+  void work(int index) {
+    workerIndex = index;
+    int idle = 0;
+    while (!stopping.load(std::memory_order_acquire)) {
+      if (void *task = find()) {
+        run(task);
+        idle = 0;
+        continue;
+      }
+      if (++idle < 64) {
+        std::this_thread::yield();
+        continue;
+      }
+      sleep([this] { return hasWork() || stopping.load(std::memory_order_acquire); });
+      idle = 0;
+    }
+  }
+};
+
+thread_local int TaskPool::workerIndex = -1;
+
+} // namespace snowball
+
+bool snowball_task_spawn(void *data) {
+  if (!snowball_task_run) return false;
+  snowball::TaskPool::get().submit(data);
+  return true;
+}
+
+void snowball_task_wait(int32_t *done) {
+  snowball::TaskPool::get().wait(reinterpret_cast<std::atomic<int32_t> *>(done));
+}
+
+uint32_t snowball_task_workers() { return snowball::TaskPool::get().size(); }
@@ -0,0 +1,204 @@
+#include "runtime.h"
+
+#include <atomic>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Body of every thread spawned by `std::thread`. It's exported by the
+/// stdlib and only linked when the program imports it, hence the weak
+/// reference.
+void snowball_thread_run(void *data) _SN_SYM("sn.thread.run") __attribute__((weak));
+
+uint64_t snowball_thread_spawn(void *data) _SN_SYM("sn.thread.spawn");
+int snowball_thread_join(uint64_t handle) _SN_SYM("sn.thread.join");
+int snowball_thread_detach(uint64_t handle) _SN_SYM("sn.thread.detach");
+uint64_t snowball_thread_id() _SN_SYM("sn.thread.id");
+void snowball_thread_yield() _SN_SYM("sn.thread.yield");
+void snowball_thread_sleep(uint64_t nanos) _SN_SYM("sn.thread.sleep");
+uint32_t snowball_thread_concurrency() _SN_SYM("sn.thread.concurrency");
+
+void *snowball_mutex_new() _SN_SYM("sn.mutex.new");
+void snowball_mutex_lock(void *mutex) _SN_SYM("sn.mutex.lock");
+bool snowball_mutex_try_lock(void *mutex) _SN_SYM("sn.mutex.try_lock");
+void snowball_mutex_unlock(void *mutex) _SN_SYM("sn.mutex.unlock");
+void snowball_mutex_destroy(void *mutex) _SN_SYM("sn.mutex.destroy");
+
+void *snowball_rwlock_new() _SN_SYM("sn.rwlock.new");
+void snowball_rwlock_read(void *lock) _SN_SYM("sn.rwlock.read");
+void snowball_rwlock_write(void *lock) _SN_SYM("sn.rwlock.write");
+void snowball_rwlock_unlock(void *lock) _SN_SYM("sn.rwlock.unlock");
+void snowball_rwlock_destroy(void *lock) _SN_SYM("sn.rwlock.destroy");
+
+void *snowball_condvar_new() _SN_SYM("sn.condvar.new");
+void snowball_condvar_wait(void *cond, void *mutex) _SN_SYM("sn.condvar.wait");
+bool snowball_condvar_wait_for(void *cond, void *mutex, uint64_t nanos) _SN_SYM("sn.condvar.wait_for");
+void snowball_condvar_notify_one(void *cond) _SN_SYM("sn.condvar.notify_one");
+void snowball_condvar_notify_all(void *cond) _SN_SYM("sn.condvar.notify_all");
+void snowball_condvar_destroy(void *cond) _SN_SYM("sn.condvar.destroy");
+
+bool snowball_once_begin(int32_t *state) _SN_SYM("sn.once.begin");
+void snowball_once_end(int32_t *state, bool done) _SN_SYM("sn.once.end");
+
+namespace snowball {
+
+static void *thread_trampoline(void *data) {
+  snowball_thread_run(data);
+  return nullptr;
+}
+
+[[noreturn]] static void thread_error(const char *operation, int error) {
+  fprintf(stderr, "[snowball internal error]: could not %s: %s\n", operation, strerror(error));
+  abort();
+}
+
+/// Locks are allocated by the runtime so the stdlib doesn't depend on the
+/// size of the pthread types of the target.
+template <typename T> static T *allocate_lock(const char *name) {
+  auto *lock = (T *)malloc(sizeof(T));
+  if (!lock) thread_error(name, ENOMEM);
+  return lock;
+}
+
+enum OnceState : int32_t { ONCE_NEW = 0, ONCE_RUNNING = 1, ONCE_DONE = 2 };
+
+} // namespace snowball
+
+uint64_t snowball_thread_spawn(void *data) {
+  if (!snowball_thread_run) {
+    errno = ENOSYS;
+    return 0;
+  }
+  pthread_t thread;
+  if (int error = pthread_create(&thread, nullptr, snowball::thread_trampoline, data)) {
+    errno = error;
+    return 0;
+  }
+  return (uint64_t)thread;
+}
+
+int snowball_thread_join(uint64_t handle) { return pthread_join((pthread_t)handle, nullptr); }
+int snowball_thread_detach(uint64_t handle) { return pthread_detach((pthread_t)handle); }
+uint64_t snowball_thread_id() { return (uint64_t)pthread_self(); }
+void snowball_thread_yield() { sched_yield(); }
+
+void snowball_thread_sleep(uint64_t nanos) {
+  struct timespec duration = {(time_t)(nanos / 1000000000), (long)(nanos % 1000000000)};
+  // Signals (e.g. the profiler's) interrupt the sleep, keep sleeping for what's left
+  while (nanosleep(&duration, &duration) == -1 && errno == EINTR) {}
+}
+
+uint32_t snowball_thread_concurrency() {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (uint32_t)count : 1;
+}
+
+void *snowball_mutex_new() {
+  auto *mutex = snowball::allocate_lock<pthread_mutex_t>("create a mutex");
+  pthread_mutex_init(mutex, nullptr);
+  return mutex;
+}
+
+void snowball_mutex_lock(void *mutex) {
+  if (int error = pthread_mutex_lock((pthread_mutex_t *)mutex)) snowball::thread_error("lock a mutex", error);
+}
+
+bool snowball_mutex_try_lock(void *mutex) { return pthread_mutex_trylock((pthread_mutex_t *)mutex) == 0; }
+void snowball_mutex_unlock(void *mutex) { pthread_mutex_unlock((pthread_mutex_t *)mutex); }
+
+void snowball_mutex_destroy(void *mutex) {
+  pthread_mutex_destroy((pthread_mutex_t *)mutex);
+  free(mutex);
+}
+
+void *snowball_rwlock_new() {
+  auto *lock = snowball::allocate_lock<pthread_rwlock_t>("create a read-write lock");
+  pthread_rwlock_init(lock, nullptr);
+  return lock;
+}
+
+void snowball_rwlock_read(void *lock) {
+  if (int error = pthread_rwlock_rdlock((pthread_rwlock_t *)lock)) snowball::thread_error("lock a read-write lock", error);
+}
+
+void snowball_rwlock_write(void *lock) {
+  if (int error = pthread_rwlock_wrlock((pthread_rwlock_t *)lock)) snowball::thread_error("lock a read-write lock", error);
+}
+
+void snowball_rwlock_unlock(void *lock) { pthread_rwlock_unlock((pthread_rwlock_t *)lock); }
+
+void snowball_rwlock_destroy(void *lock) {
+  pthread_rwlock_destroy((pthread_rwlock_t *)lock);
+  free(lock);
+}
+
+void *snowball_condvar_new() {
+  auto *cond = snowball::allocate_lock<pthread_cond_t>("create a condition variable");
+#ifdef __APPLE__
+  // note: there's no clock attribute, `wait_for` uses relative timeouts instead
+  pthread_cond_init(cond, nullptr);
+#else
+  // Timeouts are measured with the monotonic clock so changing the system
+  // time doesn't make them longer or shorter.
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cond, &attr);
+  pthread_condattr_destroy(&attr);
+#endif
+  return cond;
+}
+
+void snowball_condvar_wait(void *cond, void *mutex) {
+  pthread_cond_wait((pthread_cond_t *)cond, (pthread_mutex_t *)mutex);
+}
+
+bool snowball_condvar_wait_for(void *cond, void *mutex, uint64_t nanos) {
+#ifdef __APPLE__
+  struct timespec timeout;
+  timeout.tv_sec = nanos / 1000000000;
+  timeout.tv_nsec = nanos % 1000000000;
+  return pthread_cond_timedwait_relative_np((pthread_cond_t *)cond, (pthread_mutex_t *)mutex, &timeout) != ETIMEDOUT;
+#else
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  nanos += deadline.tv_nsec;
+  deadline.tv_sec += nanos / 1000000000;
+  deadline.tv_nsec = nanos % 1000000000;
+  return pthread_cond_timedwait((pthread_cond_t *)cond, (pthread_mutex_t *)mutex, &deadline) != ETIMEDOUT;
+#endif
+}
+
+void snowball_condvar_notify_one(void *cond) { pthread_cond_signal((pthread_cond_t *)cond); }
+void snowball_condvar_notify_all(void *cond) { pthread_cond_broadcast((pthread_cond_t *)cond); }
+
+void snowball_condvar_destroy(void *cond) {
+  pthread_cond_destroy((pthread_cond_t *)cond);
+  free(cond);
+}
+
+/// @return Whether the caller has to run the initializer. Callers that lose
+///  the race wait until the winner is done.
+bool snowball_once_begin(int32_t *state) {
+  auto *atomic = reinterpret_cast<std::atomic<int32_t> *>(state);
+  while (true) {
+    int32_t current = atomic->load(std::memory_order_acquire);
+    if (current == snowball::ONCE_DONE) return false;
+    if (current == snowball::ONCE_NEW &&
+        atomic->compare_exchange_weak(current, snowball::ONCE_RUNNING, std::memory_order_acquire))
+      return true;
+    sched_yield();
+  }
+}
+
+/// @param done Whether the initializer finished, it's run again by the
+///  next caller if it threw.
+void snowball_once_end(int32_t *state, bool done) {
+  auto *atomic = reinterpret_cast<std::atomic<int32_t> *>(state);
+  atomic->store(done ? snowball::ONCE_DONE : snowball::ONCE_NEW, std::memory_order_release);
+}
@@ -0,0 +1,29 @@
+#include "runtime.h"
+
+#include <stdint.h>
+#include <time.h>
+
+/// Clocks used by `std::time`, all of them in nanoseconds
+uint64_t snowball_time_monotonic() _SN_SYM("sn.time.monotonic");
+int64_t snowball_time_realtime() _SN_SYM("sn.time.realtime");
+uint64_t snowball_time_cpu() _SN_SYM("sn.time.cpu");
+
+namespace snowball {
+
+static int64_t read_clock(clockid_t clock) {
+  struct timespec now;
+  clock_gettime(clock, &now);
+  return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+} // namespace snowball
+
+/// @note It never goes backwards and isn't affected by changes to the
+///  system time. Reading it doesn't enter the kernel on Linux (vDSO).
+uint64_t snowball_time_monotonic() { return (uint64_t)snowball::read_clock(CLOCK_MONOTONIC); }
+
+/// @return Nanoseconds since the Unix epoch (negative before it)
+int64_t snowball_time_realtime() { return snowball::read_clock(CLOCK_REALTIME); }
+
+/// @return CPU time used by every thread of the process
+uint64_t snowball_time_cpu() { return (uint64_t)snowball::read_clock(CLOCK_PROCESS_CPUTIME_ID); }
@@ -5,6 +5,8 @@
 #include "../types/DefinedType.h"
 #include "../types/TypeAlias.h"
 
+#include <algorithm>
+
 namespace snowball {
 using namespace services;
 
@@ -34,6 +36,17 @@ void Functions::setTransformedFunction(const std::string& uuid, std::shared_ptr<
   createdFunctions[uuid] = p_fn;
 }
 
+std::vector<std::pair<std::string, size_t>> Functions::getInstantiations() const {
+  std::vector<std::pair<std::string, size_t>> result;
+  for (auto& [uuid, overloads] : functions) {
+    bool generic = std::any_of(overloads.begin(), overloads.end(), [](auto& f) { return f.function->isGeneric(); });
+    if (!generic) continue;
+    auto created = createdFunctions.find(uuid);
+    result.push_back({uuid, created == createdFunctions.end() ? 0 : created->second->getFunctions().size()});
+  }
+  return result;
+}
+
 std::optional<std::shared_ptr<transform::Item>> Functions::getTransformedFunction(const std::string uuid) {
   auto f = createdFunctions.find(uuid);
   if (f != createdFunctions.end()) return f->second;
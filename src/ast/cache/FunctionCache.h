@@ -70,6 +70,8 @@ class Functions {
   void setTransformedFunction(const std::string& uuid, std::shared_ptr<transform::Item> p_fn);
   /// @return get an item of an already transformed function
   std::optional<std::shared_ptr<transform::Item>> getTransformedFunction(const std::string uuid);
+  /// @return How many times each generic function has been instantiated (indexed by its uuid)
+  std::vector<std::pair<std::string, size_t>> getInstantiations() const;
   /// Copy a list of functions to a new list for a new type
   void performInheritance(types::DefinedType* ty, types::DefinedType* parent, bool allowConstructor = false);
 };
@@ -40,6 +40,17 @@ std::optional<Types::TypeStore> Types::getType(const std::string uuid) {
   return std::nullopt;
 }
 
+std::vector<std::pair<std::string, size_t>> Types::getInstantiations() const {
+  std::vector<std::pair<std::string, size_t>> result;
+  for (auto& [uuid, store] : types) {
+    auto cls = utils::cast<Statement::DefinedTypeDef>(store.type);
+    if (!cls || !cls->isGeneric()) continue;
+    auto instances = identifierLookup.find(uuid);
+    result.push_back({uuid, instances == identifierLookup.end() ? 0 : instances->second.size()});
+  }
+  return result;
+}
+
 } // namespace cacheComponents
 } // namespace Syntax
 } // namespace snowball
@@ -66,6 +66,8 @@ class Types {
   std::optional<std::vector<std::shared_ptr<transform::Item>>> getTransformedType(const std::string& uuid);
   /// @return All function overloads for a function
   std::optional<TypeStore> getType(const std::string uuid);
+  /// @return How many times each generic type has been instantiated (indexed by its uuid)
+  std::vector<std::pair<std::string, size_t>> getInstantiations() const;
 };
 
 } // namespace cacheComponents
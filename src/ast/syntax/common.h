@@ -4,6 +4,7 @@
 #include "../../sourceInfo/DBGSourceInfo.h"
 
 #include <assert.h>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <unordered_map>
@@ -42,6 +43,7 @@ enum Attributes {
   FIRST_ARG_IS_SELF,
   UNSAFE_FUNC_NOT_BODY,
   UNSAFE, // also used for blocks
+  RESTRICT,
 
   // Builting related attributes
   BUILTIN,
@@ -57,6 +59,17 @@ enum Attributes {
   CLASS_EXTENDS,
   NO_CONSTRUCTOR,
 
+  // Loop attributes
+  LOOP_UNROLL,
+  LOOP_VECTORIZE,
+  LOOP_NO_VECTORIZE,
+
+  // Return attributes
+  TAIL_CALL,
+
+  // Variable attributes
+  THREAD_LOCAL,
+
   // Import attributes
   MACROS,
 };
@@ -84,7 +97,7 @@ class AttributeHolder {
    * @param attribute The attribute to check.
    * @return True if the attribute is set, false otherwise.
    */
-  bool hasAttribute(Attributes attribute) const { return (m_attributes & (1 << static_cast<int>(attribute))) != 0; }
+  bool hasAttribute(Attributes attribute) const { return (m_attributes & (1ull << static_cast<int>(attribute))) != 0; }
   /**
    * Sets the bit for a specific attribute in the `m_attributes`
    * variable.
@@ -93,12 +106,12 @@ class AttributeHolder {
    */
   auto addAttribute(Attributes attribute, StoreType args = {}) {
     arguments[attribute] = args;
-    return m_attributes |= (1 << static_cast<int>(attribute));
+    return m_attributes |= (1ull << static_cast<int>(attribute));
   }
   /**
    * Sets a new list of attributes to the current holder
    */
-  void setAttributes(unsigned int attribute, std::unordered_map<Attributes, StoreType>& args) {
+  void setAttributes(uint64_t attribute, std::unordered_map<Attributes, StoreType>& args) {
     m_attributes = attribute;
     arguments = args;
   }
@@ -114,7 +127,9 @@ class AttributeHolder {
    * Sets the attributes from a holder
    */
   void setAttributes(AttributeHolder* holder) {
-    arguments = std::move(holder->getAllAttributeArgs());
+    // note: the arguments are copied because the same node may be transformed more
+    // than once (e.g. generic functions).
+    arguments = holder->getAllAttributeArgs();
     m_attributes = holder->m_attributes;
   }
   /**
@@ -123,7 +138,7 @@ class AttributeHolder {
    *
    * @param attribute The attribute to remove.
    */
-  void removeAttribute(Attributes attribute) { m_attributes &= ~(1 << static_cast<int>(attribute)); }
+  void removeAttribute(Attributes attribute) { m_attributes &= ~(1ull << static_cast<int>(attribute)); }
   /**
    * Clears all attributes for the node by setting `m_attributes`
    * to zero.
@@ -154,7 +169,7 @@ class AttributeHolder {
 
  private:
   /** The bit field storing the attributes for the node. */
-  unsigned int m_attributes = 0;
+  uint64_t m_attributes = 0;
 };
 
 struct Macro;
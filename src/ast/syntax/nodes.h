@@ -170,6 +170,30 @@ struct Cast : public AcceptorExtend<Cast, Base> {
   ACCEPT()
 };
 
+/**
+ * @brief A representation of an await expression, it suspends
+ *  the current coroutine until the awaited one finishes.
+ * @example of awaiting the result of an async function
+ *  1 | await read_line()
+ *    | ^^^^^ ^^^^^^^^^^^ - future to await
+ *    | |_____ await keyword
+ */
+struct Await : public AcceptorExtend<Await, Base> {
+ private:
+  /// @brief Future that's being awaited
+  Base* value;
+
+ public:
+  using AcceptorExtend::AcceptorExtend;
+
+  Await(Base* value) : value(value) {};
+
+  /// @return The future to await
+  auto getValue() { return value; }
+
+  ACCEPT()
+};
+
 /**
  * Representation of a function call. Functions aren't generated
  * until it's being called.
@@ -519,6 +543,8 @@ struct FunctionDef : public AcceptorExtend<FunctionDef, Base>,
   // Declaration of wether or not the function is declared
   // as mutable.
   bool _mutable = false;
+  /// If the function is declared as async (a coroutine).
+  bool _async = false;
 
   /// @brief Context state for the function (it shoudn't be used often)
   std::shared_ptr<snowball::Syntax::transform::ContextState> _contextState = nullptr;
@@ -567,6 +593,11 @@ struct FunctionDef : public AcceptorExtend<FunctionDef, Base>,
   /// @brief Declare a function mutable or not.
   void isMutable(bool m);
 
+  /// @return `true` if the function is declared as async
+  bool isAsync();
+  /// @brief Declare a function async or not.
+  void setAsync(bool a = true);
+
   /// Check if the function is declared as an extern function
   virtual bool isExtern() { return false; }
   /// Check if the function is declared as a constructor
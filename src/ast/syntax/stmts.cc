@@ -35,6 +35,8 @@ bool FunctionDef::isStatic() { return _static; }
 void FunctionDef::setStatic(bool s) { _static = s; }
 bool FunctionDef::isMutable() { return _mutable; }
 void FunctionDef::isMutable(bool m) { _mutable = m; }
+bool FunctionDef::isAsync() { return _async; }
+void FunctionDef::setAsync(bool a) { _async = a; }
 void ConstructorDef::setSuperArgs(std::vector<Expression::Base*> args) { superArgs = args; }
 void ConstructorDef::setInitArgs(std::map<Expression::Identifier*, Expression::Base*> list) { initArgs = list; }
 std::map<Expression::Identifier*, Expression::Base*> ConstructorDef::getInitArgs() const { return initArgs; }
@@ -96,6 +96,12 @@ class Linker {
    *
    */
   std::string getPlatformTriple();
+  /**
+   * @brief Whether the linker can fold identical code sections (`--icf`).
+   *
+   * lld, gold and mold support it but the GNU (bfd) linker and ld64 don't.
+   */
+  bool supportsICF();
 };
 
 // check if we are in a supported platform
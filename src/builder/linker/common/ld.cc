@@ -2,7 +2,14 @@
 #include "../../../utils/utils.h"
 #include "../Linker.h"
 
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FileUtilities.h>
 #include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Program.h>
+
+#include <optional>
 
 namespace snowball {
 namespace linker {
@@ -16,6 +23,14 @@ int Linker::link(std::string& input, std::string& output, std::vector<std::strin
   auto current = utils::get_lib_folder();
   rpaths.insert(rpaths.begin(), (current / ".." / "lib").string());
   constructLinkerArgs(input, output, args);
+  if (ctx.size.icf) {
+    if (supportsICF()) {
+      linkerArgs.push_back("--icf=safe");
+    } else {
+      Logger::warning(FMT("'%s' can't fold identical code, only functions identical at the IR level are folded",
+                          ldPath.c_str()));
+    }
+  }
   linkerArgs.insert(linkerArgs.begin(), ldPath);
   DEBUG_CODEGEN("Invoking linker (" LD_PATH " with stdlib at " STATICLIB_DIR ")");
   DEBUG_CODEGEN("Linker command: %s", utils::join(linkerArgs.begin(), linkerArgs.end(), " ").c_str());
@@ -27,6 +42,22 @@ int Linker::link(std::string& input, std::string& output, std::vector<std::strin
   return EXIT_SUCCESS;
 }
 
+bool Linker::supportsICF() {
+  // note: the linker is run without a shell, so its path is never split
+  //  or interpreted, whatever characters it contains.
+  auto program = llvm::sys::findProgramByName(ldPath);
+  if (!program) return false;
+  llvm::SmallString<128> versionFile;
+  if (llvm::sys::fs::createTemporaryFile("snowball-ld-version", "txt", versionFile)) return false;
+  llvm::FileRemover remover(versionFile);
+  std::optional<llvm::StringRef> redirects[] = {llvm::StringRef(""), versionFile.str(), llvm::StringRef("")};
+  if (llvm::sys::ExecuteAndWait(*program, {*program, "--version"}, std::nullopt, redirects) != 0) return false;
+  auto buffer = llvm::MemoryBuffer::getFile(versionFile);
+  if (!buffer) return false;
+  auto version = (*buffer)->getBuffer();
+  return version.contains("LLD") || version.contains("gold") || version.contains("mold");
+}
+
 std::string Linker::getPlatformTriple() {
   switch (target.getArch()) {
     case llvm::Triple::arm:
@@ -19,8 +19,14 @@ namespace codegen {
 llvm::DISubprogram* LLVMBuilder::getDISubprogramForFunc(ir::Func* x) {
   const auto& srcInfo = x->getDBGInfo();
   auto file = dbg.getFile(srcInfo->getSourceInfo()->getPath());
-  auto derivedType = llvm::cast<llvm::DIDerivedType>(getDIType(x->getType()));
-  auto subroutineType = llvm::cast<llvm::DISubroutineType>(derivedType->getRawBaseType());
+  llvm::DISubroutineType* subroutineType = nullptr;
+  if (dbg.variables()) {
+    auto derivedType = llvm::cast<llvm::DIDerivedType>(getDIType(x->getType()));
+    subroutineType = llvm::cast<llvm::DISubroutineType>(derivedType->getRawBaseType());
+  } else {
+    // Line tables don't need any type information
+    subroutineType = dbg.builder->createSubroutineType(dbg.builder->getOrCreateTypeArray({}));
+  }
   std::string baseName = x->getNiceName();
   llvm::DISubprogram* subprogram = dbg.builder->createFunction(
                                      file,
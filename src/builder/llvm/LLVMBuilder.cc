@@ -68,6 +68,8 @@
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Transforms/Utils/Debugify.h>
 
+#include <mutex>
+
 namespace snowball {
 using namespace utils;
 
@@ -97,64 +99,88 @@ llvm::Value* LLVMBuilder::load(llvm::Value* v, types::Type* ty) {
   return v;
 }
 
+namespace {
+/// @brief Initialize all LLVM targets and passes. LLVM's registries are
+///  process-wide, so this is only done once even if many builders exist.
+void initializeLLVM() {
+  static std::once_flag initialized;
+  std::call_once(initialized, [] {
+    llvm::InitializeAllTargetInfos();
+    llvm::InitializeAllTargets();
+    llvm::InitializeAllTargetMCs();
+    llvm::InitializeAllAsmParsers();
+    llvm::InitializeAllAsmPrinters();
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+    // Initialize passes
+    auto& registry = *llvm::PassRegistry::getPassRegistry();
+    llvm::initializeCore(registry);
+    llvm::initializeScalarOpts(registry);
+    llvm::initializeVectorization(registry);
+    llvm::initializeIPO(registry);
+    llvm::initializeAnalysis(registry);
+    llvm::initializeTransformUtils(registry);
+    llvm::initializeInstCombine(registry);
+    llvm::initializeXRayInstrumentationPass(registry);
+    llvm::initializeTarget(registry);
+    llvm::initializeExpandMemCmpPassPass(registry);
+    llvm::initializeScalarizeMaskedMemIntrinLegacyPassPass(registry);
+    llvm::initializeSelectOptimizePass(registry);
+    llvm::initializeCodeGenPreparePass(registry);
+    llvm::initializeAtomicExpandPass(registry);
+    llvm::initializeMergeICmpsLegacyPassPass(registry);
+    llvm::initializeWinEHPreparePass(registry);
+    llvm::initializeDwarfEHPrepareLegacyPassPass(registry);
+    llvm::initializeSafeStackLegacyPassPass(registry);
+    llvm::initializeSjLjEHPreparePass(registry);
+    llvm::initializePreISelIntrinsicLoweringLegacyPassPass(registry);
+    llvm::initializeGlobalMergePass(registry);
+    llvm::initializeIndirectBrExpandPassPass(registry);
+    llvm::initializeInterleavedLoadCombinePass(registry);
+    llvm::initializeInterleavedAccessPass(registry);
+    llvm::initializeUnreachableBlockElimLegacyPassPass(registry);
+    llvm::initializeExpandReductionsPass(registry);
+    llvm::initializeExpandVectorPredicationPass(registry);
+    llvm::initializeWasmEHPreparePass(registry);
+    llvm::initializeWriteBitcodePassPass(registry);
+    llvm::initializeHardwareLoopsPass(registry);
+    llvm::initializeReplaceWithVeclibLegacyPass(registry);
+    llvm::initializeTypePromotionLegacyPass(registry);
+  });
+}
+} // namespace
+
 LLVMBuilder::LLVMBuilder(
-  std::shared_ptr<ir::MainModule> mod, app::Options::Optimization optimizationLevel, bool testMode, bool benchMode
+  std::shared_ptr<ir::MainModule> mod, app::Options::Optimization optimizationLevel, bool testMode, bool benchMode,
+  app::Options::TargetOptions targetOptions, app::Options::ProfileOptions profileOptions,
+  app::Options::DebugOptions debugOptions, app::Options::RemarkOptions remarkOptions,
+  app::Options::SizeOptions sizeOptions
 )
-  : iModule(mod) {
+  : iModule(mod), targetOptions(targetOptions), profileOptions(profileOptions), remarkOptions(remarkOptions),
+    sizeOptions(sizeOptions) {
   ctx->testMode = testMode;
   ctx->benchmarkMode = benchMode;
   ctx->optimizationLevel = optimizationLevel;
   dbg.debug = ctx->optimizationLevel == app::Options::Optimization::OPTIMIZE_O0;
-  llvm::InitializeAllTargetInfos();
-  llvm::InitializeAllTargets();
-  llvm::InitializeAllTargetMCs();
-  llvm::InitializeAllAsmParsers();
-  llvm::InitializeAllAsmPrinters();
-  llvm::InitializeNativeTarget();
-  llvm::InitializeNativeTargetAsmPrinter();
-  llvm::InitializeNativeTargetAsmParser();
-  // Initialize passes
-  auto& registry = *llvm::PassRegistry::getPassRegistry();
-  llvm::initializeCore(registry);
-  llvm::initializeScalarOpts(registry);
-  llvm::initializeVectorization(registry);
-  llvm::initializeIPO(registry);
-  llvm::initializeAnalysis(registry);
-  llvm::initializeTransformUtils(registry);
-  llvm::initializeInstCombine(registry);
-  llvm::initializeXRayInstrumentationPass(registry);
-  llvm::initializeTarget(registry);
-  llvm::initializeExpandMemCmpPassPass(registry);
-  llvm::initializeScalarizeMaskedMemIntrinLegacyPassPass(registry);
-  llvm::initializeSelectOptimizePass(registry);
-  llvm::initializeCodeGenPreparePass(registry);
-  llvm::initializeAtomicExpandPass(registry);
-  llvm::initializeMergeICmpsLegacyPassPass(registry);
-  llvm::initializeWinEHPreparePass(registry);
-  llvm::initializeDwarfEHPrepareLegacyPassPass(registry);
-  llvm::initializeSafeStackLegacyPassPass(registry);
-  llvm::initializeSjLjEHPreparePass(registry);
-  llvm::initializePreISelIntrinsicLoweringLegacyPassPass(registry);
-  llvm::initializeGlobalMergePass(registry);
-  llvm::initializeIndirectBrExpandPassPass(registry);
-  llvm::initializeInterleavedLoadCombinePass(registry);
-  llvm::initializeInterleavedAccessPass(registry);
-  llvm::initializeUnreachableBlockElimLegacyPassPass(registry);
-  llvm::initializeExpandReductionsPass(registry);
-  llvm::initializeExpandVectorPredicationPass(registry);
-  llvm::initializeWasmEHPreparePass(registry);
-  llvm::initializeWriteBitcodePassPass(registry);
-  llvm::initializeHardwareLoopsPass(registry);
-  llvm::initializeReplaceWithVeclibLegacyPass(registry);
-  llvm::initializeTypePromotionLegacyPass(registry);
+  switch (debugOptions.info) {
+    case app::Options::DEBUG_INFO_DEFAULT:
+      dbg.kind = dbg.debug ? llvm::DICompileUnit::FullDebug : llvm::DICompileUnit::NoDebug;
+      break;
+    case app::Options::DEBUG_INFO_NONE: dbg.kind = llvm::DICompileUnit::NoDebug; break;
+    case app::Options::DEBUG_INFO_LINE_TABLES: dbg.kind = llvm::DICompileUnit::LineTablesOnly; break;
+    case app::Options::DEBUG_INFO_FULL: dbg.kind = llvm::DICompileUnit::FullDebug; break;
+  }
+  // Development builds of the compiler always verify the generated code.
+  dbg.verify = debugOptions.verifyIR || _SN_DEBUG;
+  initializeLLVM();
   newContext();
   module = newModule();
 }
 
 std::unique_ptr<llvm::Module> LLVMBuilder::newModule() {
   auto m = std::make_unique<llvm::Module>("snowball compiled project", *context);
-  auto engine = llvm::EngineBuilder();
-  target = engine.selectTarget();
+  target = createTargetMachine();
   m->setDataLayout(target->createDataLayout());
   m->setTargetTriple(target->getTargetTriple().str());
   builder = std::make_unique<llvm::IRBuilder<>>(*context);
@@ -169,7 +195,10 @@ std::unique_ptr<llvm::Module> LLVMBuilder::newModule() {
                ("Snowball version " _SNOWBALL_VERSION),
                !dbg.debug,
                {},
-               /*RV=*/0
+               /*RV=*/0,
+               /*SplitName=*/ "",
+               // Modules without debug info get it stripped after optimization.
+               dbg.kind == llvm::DICompileUnit::LineTablesOnly ? dbg.kind : llvm::DICompileUnit::FullDebug
              );
   m->addModuleFlag(llvm::Module::Warning, "Debug Info Version", llvm::DEBUG_METADATA_VERSION);
   m->addModuleFlag(llvm::Module::Warning, "Snowball Compiler ID", _SNOWBALL_VERSION_NUMBER);
@@ -183,8 +212,61 @@ std::unique_ptr<llvm::Module> LLVMBuilder::newModule() {
   return m;
 }
 
+LLVMBuilder::~LLVMBuilder() {
+  // The module must be destroyed before the context that owns its types.
+  dbg.builder.reset();
+  builder.reset();
+  module.reset();
+  context.reset();
+  delete target;
+}
+
+llvm::TargetMachine* LLVMBuilder::createTargetMachine() {
+  auto engine = llvm::EngineBuilder();
+  auto cpu = targetOptions.cpu;
+  if (cpu == "native") cpu = llvm::sys::getHostCPUName().str();
+  std::vector<std::string> features;
+  if (targetOptions.features == "native" || (targetOptions.cpu == "native" && targetOptions.features.empty())) {
+    llvm::StringMap<bool> hostFeatures;
+    if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
+      for (auto& feature : hostFeatures) {
+        features.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+      }
+    }
+  } else if (!targetOptions.features.empty()) {
+    for (auto feature : utils::split(targetOptions.features, ",")) {
+      if (!feature.empty()) features.push_back(feature);
+    }
+  }
+  engine.setMCPU(cpu);
+  engine.setMAttrs(features);
+  switch (ctx->optimizationLevel) {
+    case app::Options::Optimization::OPTIMIZE_O0: engine.setOptLevel(llvm::CodeGenOpt::None); break;
+    case app::Options::Optimization::OPTIMIZE_O1: engine.setOptLevel(llvm::CodeGenOpt::Less); break;
+    case app::Options::Optimization::OPTIMIZE_O3: engine.setOptLevel(llvm::CodeGenOpt::Aggressive); break;
+    default: engine.setOptLevel(llvm::CodeGenOpt::Default); break;
+  }
+  auto machine = engine.selectTarget();
+  if (!machine) {
+    throw SNError(Error::LLVM_INTERNAL, FMT("Could not create a target machine for CPU '%s'!", cpu.c_str()));
+  }
+  if (ctx->optimizationLevel == app::Options::Optimization::OPTIMIZE_O0) {
+    // Debug builds care about compile time, use the fast instruction selector.
+    machine->setGlobalISel(false);
+    machine->setFastISel(true);
+  }
+  if (sizeOptions.icf) {
+    // The linker folds sections, and it needs to know which functions
+    // have their address taken to do it safely.
+    machine->Options.FunctionSections = true;
+    machine->Options.EmitAddrsig = true;
+  }
+  return machine;
+}
+
 void LLVMBuilder::newContext() {
   context = std::make_unique<llvm::LLVMContext>();
+  setupDiagnostics();
   // context->setOpaquePointers(false);
 }
 
@@ -203,7 +285,7 @@ llvm::DIFile* LLVMBuilder::DebugInfo::getFile(const std::string& path) {
 }
 
 void LLVMBuilder::dump() { this->print(llvm::errs()); }
-void LLVMBuilder::print(llvm::raw_fd_ostream& s) { module->print(s, nullptr); }
+void LLVMBuilder::print(llvm::raw_ostream& s) { module->print(s, nullptr); }
 
 #define ITERATE_FUNCTIONS for (auto fn = functions.begin(); fn != functions.end(); ++fn)
 #define ITERATE_RFUNCTIONS for (auto fn = functions.rbegin(); fn != functions.rend(); ++fn)
@@ -252,6 +334,7 @@ void LLVMBuilder::codegen() {
           } else {
             buildBodiedFunction(llvmFn, f);
             setPersonalityFunction(llvmFn);
+            if (!dbg.verify) continue;
             std::string module_error_string;
             llvm::raw_string_ostream module_error_stream(module_error_string);
             llvm::verifyFunction(*llvmFn, &module_error_stream);
@@ -284,10 +367,13 @@ void LLVMBuilder::codegen() {
       }
     }
   }
+  assignClassIds();
   INIT_MODULES(false); // Create function declarations
   INIT_MODULES(true); // Create function bodies
   initializeRuntime();
+  inferNoUnwind();
   dbg.builder->finalize();
+  if (!dbg.verify) return;
   DEBUG_CODEGEN("Finished codegen, proceeding to verify module");
   std::string module_error_string;
   llvm::raw_string_ostream module_error_stream(module_error_string);
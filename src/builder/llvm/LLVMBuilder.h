@@ -14,6 +14,7 @@
 #include "../../ir/values/Func.h"
 #include "../../ir/values/ReferenceTo.h"
 #include "../../ir/values/Value.h"
+#include "SizeReport.h"
 
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DIBuilder.h>
@@ -22,11 +23,15 @@
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/ValueHandle.h>
+#include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Target/TargetMachine.h>
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 #ifndef __SNOWBALL_LLVM_BUILDER_H_
 #define __SNOWBALL_LLVM_BUILDER_H_
@@ -34,11 +39,6 @@
 namespace snowball {
 namespace codegen {
 
-namespace llvm_utils {
-int typeIdxLookup(const std::string& name);
-} // namespace llvm_utils
-
-using namespace llvm_utils;
 
 /**
  * @brief Some context so that we can know
@@ -115,6 +115,11 @@ class LLVMBuilderContext {
   app::Options::Optimization optimizationLevel = app::Options::Optimization::OPTIMIZE_O0;
   // Type information about ALLLL the types being used
   std::map<ir::id_t, std::shared_ptr<types::BaseType>> typeInfo;
+  /// @brief Class id ranges used to match exceptions, indexed by mangled name
+  /// @see LLVMBuilder::assignClassIds
+  std::map<std::string, std::pair<int32_t, int32_t>> classIds;
+  /// @brief Next class id given to a type that's not part of the class hierarchy
+  int32_t nextClassId = 1;
   /// @brief Type info for closures
   struct ClosureContext {
     std::vector<ir::id_t> variables;
@@ -130,6 +135,21 @@ class LLVMBuilderContext {
     // The break block for the current loop
     llvm::BasicBlock* breakBlock = nullptr;
   } loop;
+  /// @brief Coroutine information (only set while generating an async function)
+  struct {
+    // Token returned by `llvm.coro.id`
+    llvm::Value* id = nullptr;
+    // Handle of the coroutine frame
+    llvm::Value* handle = nullptr;
+    // Storage for the value produced by the coroutine (nullptr if it's void)
+    llvm::Value* promise = nullptr;
+    // Frees the coroutine frame when it's destroyed
+    llvm::BasicBlock* cleanupBlock = nullptr;
+    // Returns to the caller or resumer of the coroutine
+    llvm::BasicBlock* suspendBlock = nullptr;
+    // Final suspension point, returns branch here
+    llvm::BasicBlock* finalBlock = nullptr;
+  } coroutine;
 };
 
 /**
@@ -146,6 +166,8 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
   // Some sort of cache to prevent struct-like types
   // from being generated over and over again.
   std::map<ir::id_t, llvm::Type*> types;
+  // Cache for enum field types, indexed by their mangled name.
+  std::unordered_map<std::string, llvm::Type*> enumTypes;
   // Internal module given by the internal representation
   // of the program.
   std::shared_ptr<ir::Module> iModule;
@@ -162,6 +184,13 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
     std::unique_ptr<llvm::DIBuilder> builder = nullptr;
     // Debug flag
     bool debug = false;
+    // Amount of debug information to generate
+    llvm::DICompileUnit::DebugEmissionKind kind = llvm::DICompileUnit::FullDebug;
+    // Whether to run the LLVM verifier on the generated code
+    bool verify = false;
+
+    /// @return Whether variable and type information should be generated
+    bool variables() const { return kind == llvm::DICompileUnit::FullDebug; }
 
     // Create a new DIFile for llvm
     llvm::DIFile* getFile(const std::string& path);
@@ -227,6 +256,24 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
   llvm::Value* value;
   // Target machine that the module will be compiled into
   llvm::TargetMachine* target;
+  // CPU and features requested for the target machine
+  app::Options::TargetOptions targetOptions;
+  // Profile guided optimization mode
+  app::Options::ProfileOptions profileOptions;
+  // Optimization remarks to report
+  app::Options::RemarkOptions remarkOptions;
+  // File the optimization remarks are serialized into (if requested)
+  std::unique_ptr<llvm::ToolOutputFile> remarksFile;
+  // Code size reduction options
+  app::Options::SizeOptions sizeOptions;
+  // Functions folded into an identical one (folded function, function kept)
+  std::vector<std::pair<std::string, std::string>> foldedFunctions;
+  // Snowball module each generated function belongs to (for the size report)
+  std::map<llvm::Function*, std::string> functionModules;
+  // Code size and instantiation report (see `--size-report`)
+  SizeReport sizeReport;
+  // Functions of the size report, followed while the module is optimized
+  std::vector<std::pair<llvm::Function*, llvm::WeakTrackingVH>> reportedFunctions;
 
  public:
   // Create a new instance of a llvm builder
@@ -234,8 +281,14 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
     std::shared_ptr<ir::MainModule> mod,
     app::Options::Optimization optimizationLevel = app::Options::Optimization::OPTIMIZE_O0,
     bool testMode = false,
-    bool benchmarkMode = false
+    bool benchmarkMode = false,
+    app::Options::TargetOptions targetOptions = {},
+    app::Options::ProfileOptions profileOptions = {},
+    app::Options::DebugOptions debugOptions = {},
+    app::Options::RemarkOptions remarkOptions = {},
+    app::Options::SizeOptions sizeOptions = {}
   );
+  ~LLVMBuilder();
   /**
    * @brief Dump the LLVM IR code to stdout.
    *
@@ -248,11 +301,28 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
   /**
    * @brief Print the llvm IR module into a stream
    */
-  void print(llvm::raw_fd_ostream& s);
+  void print(llvm::raw_ostream& s);
   /**
    * @brief get a type info struct type
+   *
+   * Type infos are `{ i32 id, i32 end }`. Catch clauses match every
+   * exception whose class id is inside `[id, end)` and thrown exceptions
+   * only use `id`.
    */
   llvm::StructType* getTypeInfoType();
+  /**
+   * @brief Give every class an id by walking the class hierarchy in pre-order.
+   *
+   * A class and all of its subclasses get consecutive ids, so checking
+   * whether a thrown exception is a subclass of a catched type is just an
+   * interval check (`id <= thrown < end`).
+   */
+  void assignClassIds();
+  /**
+   * @return The class id range (`[id, end)`) of a type
+   * @note Types that aren't classes get a range with a single id
+   */
+  std::pair<int32_t, int32_t> getClassIdRange(types::Type* type);
   /**
    * @brief Start the codegen process
    *
@@ -267,11 +337,25 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
    * will not execute those optimization passes
    */
   void optimizeModule();
+  /// @return The code size and instantiation report for the module
+  SizeReport& getSizeReport() { return sizeReport; }
   /**
    * @brief Compile the LLVM-IR code into an object file into the
    * desired file.
    */
   int emitObjectFile(std::string out, bool log, bool object = true);
+  /**
+   * @brief Compile the module into multiple object/assembly files at once.
+   * @param outputs A list of output paths and whether they are object files
+   *  (true) or assembly files (false).
+   * @note Each output is emitted in parallel from its own copy of the
+   *  optimized module.
+   */
+  void emitObjectFiles(const std::vector<std::pair<std::string, bool>>& outputs);
+  /**
+   * @brief Write the module as LLVM bitcode into the desired file.
+   */
+  void emitBitcode(std::string out);
   /**
    * @brief It builds a value as an expression.
    * @param v Value to build
@@ -299,6 +383,24 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
    * @return An unique pointer to the new context.
    */
   void newContext();
+  /**
+   * @brief Install the diagnostic handler for the current context.
+   *
+   * Optimization remarks matching the requested filter are printed next to the
+   * snowball source they refer to and serialized into the remarks file (if any).
+   */
+  void setupDiagnostics();
+  /**
+   * @brief Create the diagnostic handler used by `setupDiagnostics`.
+   * @note It's also installed on the contexts used to emit object files in parallel.
+   */
+  std::unique_ptr<llvm::DiagnosticHandler> createDiagnosticHandler();
+  /**
+   * @brief Create a new target machine for the target the module
+   *  is being compiled to.
+   * @note The caller owns the returned target machine.
+   */
+  llvm::TargetMachine* createTargetMachine();
   /**
    * It loads a value if it's a pointer type.
    * @param v Value to load
@@ -342,6 +444,17 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
    * @return true if the intrinsic function was generated successfully,
    */
   bool buildIntrinsic(ir::Call* call);
+  /**
+   * @brief Emit an atomic operation for a memory ordering (`sn.atomic.*` intrinsics).
+   * @param order Snowball ordering (0 = relaxed, 1 = acquire, 2 = release,
+   *  3 = acquire-release, 4 = sequentially consistent).
+   * @param resultType Type of the value produced by @param emit (nullptr if none).
+   * @note Orderings that aren't known at compile time are dispatched with a switch
+   *  that collapses once the value gets propagated by the optimizer.
+   */
+  llvm::Value* buildAtomicOrdering(
+    llvm::Value* order, llvm::Type* resultType, std::function<llvm::Value*(llvm::AtomicOrdering)> emit
+  );
   /**
    * @brief It creates a new enum type and a new constant struct
    * value for a virtual table for @param call
@@ -352,8 +465,11 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
    * @param cond Condition to branch
    * @param thenBlock Block to branch if condition is true
    * @param elseBlock Block to branch if condition is false
+   * @param weights Optional branch weights metadata
    */
-  void createCondBr(llvm::Value* cond, llvm::BasicBlock* thenBlock, llvm::BasicBlock* elseBlock);
+  void createCondBr(
+    llvm::Value* cond, llvm::BasicBlock* thenBlock, llvm::BasicBlock* elseBlock, llvm::MDNode* weights = nullptr
+  );
   /**
    * @brief It creates a new enum field type
    * @param ty The enum type
@@ -379,6 +495,25 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
    * llvm function.
    */
   llvm::Function* buildBodiedFunction(llvm::Function* llvmFn, ir::Func* fn);
+  /**
+   * @brief Generate the start of an async function.
+   *
+   * It allocates the coroutine frame, stores its handle into the
+   * returned future and suspends right away: coroutines don't run
+   * until they are resumed for the first time. It also creates the
+   * blocks used to suspend, destroy and finish the coroutine.
+   *
+   * @param body Block where the coroutine starts once resumed.
+   */
+  void buildCoroutinePrologue(llvm::Function* llvmFn, ir::Func* fn, llvm::BasicBlock* body);
+  /**
+   * @brief Suspend the current coroutine.
+   * @param resume Block where the coroutine continues when it's resumed.
+   * @param destroy Block used if the coroutine is destroyed while suspended
+   *  (the frame cleanup block by default).
+   * @param isFinal Whether it's the final suspension point.
+   */
+  void createCoroutineSuspend(llvm::BasicBlock* resume, llvm::BasicBlock* destroy = nullptr, bool isFinal = false);
   /**
    * @brief Set a "personality" function attached to a snowball
    *  generated function.
@@ -387,6 +522,42 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
    *  implement an throw/catch exception runtime.
    */
   void setPersonalityFunction(llvm::Function* func);
+  /**
+   * @brief Mark every function that provably can't throw as `nounwind`.
+   *
+   * A function may throw if it calls the throw runtime, an external function
+   * that isn't known to be `nounwind`, an unknown (indirect) function or
+   * another function that may throw. Invokes of functions that can't throw
+   * are turned into plain calls and personality functions are removed from
+   * functions that are left without landing pads.
+   */
+  void inferNoUnwind();
+  /**
+   * @brief Merge the functions that have identical code (e.g. generic
+   *  instantiations whose types have the same layout).
+   *
+   * Functions are merged with LLVM's MergeFunctions pass, which keeps a thunk
+   * for the functions whose address may be significant. The folded functions
+   * are recorded in `foldedFunctions` for the ICF report.
+   */
+  void foldIdenticalFunctions();
+  /**
+   * @brief Print how much machine code was saved by folding identical functions.
+   * @param object The object file generated for the module.
+   */
+  void reportFoldedFunctions(const std::string& object);
+  /**
+   * @brief Fill the machine code sizes of the size report and print it (or
+   *  write it as JSON if a file was given).
+   * @param object The object file generated for the module.
+   */
+  void reportSize(const std::string& object);
+  /// @brief Add every defined function to the size report with its unoptimized instruction count.
+  void recordSizesBeforeOptimization();
+  /// @brief Update the size report with the instruction counts of the optimized module.
+  void recordSizesAfterOptimization();
+  /// @return The size of every symbol defined in an object file
+  std::map<std::string, uint64_t> getSymbolSizes(const std::string& object);
   /**
    * @brief It generates the test functions for the current module.
    */
@@ -400,6 +571,17 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
    * depending on the current context.
    */
   llvm::Value* createCall(llvm::FunctionType* ty, llvm::Value* callee, llvm::ArrayRef<llvm::Value*> args);
+  /**
+   * @brief Turn the call that has just been generated into a `musttail` call.
+   *
+   * An error is reported if the call can't be a guaranteed tail call (e.g.
+   * the signatures don't match or it's inside a try block) instead of
+   * silently generating a normal call.
+   *
+   * @param call The call marked with `return @tail ...`.
+   * @param result The value that's going to be returned (nullptr if the function returns void).
+   */
+  void setMustTailCall(ir::Call* call, llvm::Value* result);
   /**
    * @brief It generates the LLVM IR contents that the user has
    *  manually inserted by using "inline LLVM".
@@ -482,6 +664,19 @@ class LLVMBuilder : AcceptorExtend<LLVMBuilder, ValueVisitor> {
    * @brief Creates a new instance of an exception.
    */
   llvm::Value* createException(llvm::Value* val, types::Type* type);
+  /**
+   * @brief Gives the record of a catched exception back to the runtime
+   *  so it can be reused by the next throw.
+   */
+  void releaseException(llvm::Value* exception);
+  /**
+   * @brief Get an outlined `cold` function that creates and throws an
+   *  exception of the given type.
+   *
+   * Throw sites call it instead of creating and throwing the exception
+   * inline, keeping the exception handling code away from the hot path.
+   */
+  llvm::Function* getColdThrowFunction(types::Type* type);
   /**
    * @brief It initializes the runtime. This function is called
    * before any other function is generated.
@@ -0,0 +1,81 @@
+#include "SizeReport.h"
+
+#include "../../utils/colors.h"
+#include "../../utils/logger.h"
+
+#include <algorithm>
+#include <map>
+
+namespace snowball {
+namespace codegen {
+
+std::vector<SizeReport::Module> SizeReport::getModules() const {
+  std::map<std::string, Module> modules;
+  for (auto& function : functions) {
+    auto& module = modules[function.module];
+    module.name = function.module;
+    module.bytes += function.bytes;
+    module.functions++;
+    module.irBefore += function.irBefore;
+    module.irAfter += function.irAfter;
+  }
+  std::vector<Module> result;
+  for (auto& [_, module] : modules) result.push_back(module);
+  std::sort(result.begin(), result.end(), [](auto& a, auto& b) { return a.bytes > b.bytes; });
+  return result;
+}
+
+void SizeReport::print(const std::string& sort, size_t limit) const {
+  auto sorted = functions;
+  std::sort(sorted.begin(), sorted.end(), [&](const Function& a, const Function& b) {
+    if (sort == "name") return a.name < b.name;
+    if (sort == "ir") return a.irAfter > b.irAfter;
+    return a.bytes > b.bytes;
+  });
+  uint64_t totalBytes = 0;
+  for (auto& function : functions) totalBytes += function.bytes;
+  Logger::log(FMT("\n%sFunctions%s (%i, %llu bytes)", BOLD, RESET, (int) functions.size(),
+                  (unsigned long long) totalBytes));
+  Logger::log(FMT("%s%10s %10s %10s  %s%s", BBLK, "bytes", "IR before", "IR after", "function", RESET));
+  for (size_t i = 0; i < sorted.size() && i < limit; i++) {
+    auto& f = sorted[i];
+    Logger::log(FMT("%10llu %10u %10u  %s", (unsigned long long) f.bytes, f.irBefore, f.irAfter, f.name.c_str()));
+  }
+  auto sortedTemplates = templates;
+  std::sort(sortedTemplates.begin(), sortedTemplates.end(), [](auto& a, auto& b) {
+    return a.instantiations > b.instantiations;
+  });
+  Logger::log(FMT("\n%sGeneric instantiations%s", BOLD, RESET));
+  Logger::log(FMT("%s%10s %10s  %s%s", BBLK, "count", "kind", "template", RESET));
+  for (size_t i = 0; i < sortedTemplates.size() && i < limit; i++) {
+    auto& t = sortedTemplates[i];
+    Logger::log(FMT("%10i %10s  %s", (int) t.instantiations, t.kind.c_str(), t.name.c_str()));
+  }
+  Logger::log(FMT("\n%sModules%s", BOLD, RESET));
+  Logger::log(FMT("%s%10s %10s %10s %10s  %s%s", BBLK, "bytes", "functions", "IR before", "IR after", "module", RESET));
+  for (auto& m : getModules()) {
+    Logger::log(FMT("%10llu %10u %10u %10u  %s", (unsigned long long) m.bytes, m.functions, m.irBefore, m.irAfter,
+                    m.name.c_str()));
+  }
+  Logger::log("");
+}
+
+nlohmann::json SizeReport::toJSON() const {
+  auto result = nlohmann::json {{"functions", nlohmann::json::array()}, {"templates", nlohmann::json::array()},
+                                {"modules", nlohmann::json::array()}};
+  for (auto& f : functions) {
+    result["functions"].push_back({{"name", f.name}, {"module", f.module}, {"bytes", f.bytes},
+                                   {"irBefore", f.irBefore}, {"irAfter", f.irAfter}});
+  }
+  for (auto& t : templates) {
+    result["templates"].push_back({{"name", t.name}, {"kind", t.kind}, {"instantiations", t.instantiations}});
+  }
+  for (auto& m : getModules()) {
+    result["modules"].push_back({{"name", m.name}, {"bytes", m.bytes}, {"functions", m.functions},
+                                 {"irBefore", m.irBefore}, {"irAfter", m.irAfter}});
+  }
+  return result;
+}
+
+} // namespace codegen
+} // namespace snowball
@@ -0,0 +1,66 @@
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#ifndef __SNOWBALL_CODEGEN_SIZE_REPORT_H_
+#define __SNOWBALL_CODEGEN_SIZE_REPORT_H_
+
+namespace snowball {
+namespace codegen {
+
+/**
+ * @brief Code size and instantiation report (`--size-report`).
+ *
+ * It's filled while the module is generated, optimized and emitted and it's
+ * printed (or written as JSON) once the object file exists, since machine
+ * code sizes are read from its symbol table.
+ */
+struct SizeReport {
+  struct Function {
+    std::string name;
+    // Snowball module the function was generated for
+    std::string module;
+    // Machine code size (0 if the function was inlined or removed)
+    uint64_t bytes = 0;
+    // IR instructions before and after optimizing the module
+    unsigned irBefore = 0;
+    unsigned irAfter = 0;
+  };
+
+  struct Template {
+    std::string name;
+    // Either "type" or "function"
+    std::string kind;
+    size_t instantiations = 0;
+  };
+
+  struct Module {
+    std::string name;
+    uint64_t bytes = 0;
+    unsigned functions = 0;
+    unsigned irBefore = 0;
+    unsigned irAfter = 0;
+  };
+
+  std::vector<Function> functions;
+  std::vector<Template> templates;
+
+  /// @return The totals for every snowball module
+  std::vector<Module> getModules() const;
+  /**
+   * @brief Print the report as tables.
+   * @param sort Column used to sort the functions ("size", "ir" or "name")
+   * @param limit Maximum amount of rows printed for each table
+   */
+  void print(const std::string& sort, size_t limit = 25) const;
+  /// @return The whole report in its machine-readable form
+  nlohmann::json toJSON() const;
+};
+
+} // namespace codegen
+} // namespace snowball
+
+#endif // __SNOWBALL_CODEGEN_SIZE_REPORT_H_
@@ -18,10 +18,13 @@ void LLVMBuilder::addGlobalVariable(std::shared_ptr<ir::VariableDeclaration> var
   }
   auto srcInfo = var->getDBGInfo();
   auto file = dbg.getFile(var->getSourceInfo()->getPath());
-  auto debugVar = dbg.builder->createGlobalVariableExpression(
-                    dbg.unit, var->getIdentifier(), var->getIdentifier(), file, srcInfo->line, getDIType(var->getType()),
-                    var->isExternDecl()
-                  );
+  llvm::DIGlobalVariableExpression* debugVar = nullptr;
+  if (dbg.variables()) {
+    debugVar = dbg.builder->createGlobalVariableExpression(
+                 dbg.unit, var->getIdentifier(), var->getIdentifier(), file, srcInfo->line, getDIType(var->getType()),
+                 var->isExternDecl()
+               );
+  }
   if (var->isExternDecl()) {
     auto gvar = new llvm::GlobalVariable(
       /*Module=*/*module,
@@ -31,8 +34,9 @@ void LLVMBuilder::addGlobalVariable(std::shared_ptr<ir::VariableDeclaration> var
       /*Initializer=*/nullptr,
       /*Name=*/var->getIdentifier()
     );
+    if (var->isThreadLocal()) gvar->setThreadLocal(true);
     ctx->addSymbol(var->getId(), gvar);
-    gvar->addDebugInfo(debugVar);
+    if (debugVar) gvar->addDebugInfo(debugVar);
     return;
   }
   if (utils::dyn_cast<ir::ConstantValue>(var->getValue())) {
@@ -46,8 +50,29 @@ void LLVMBuilder::addGlobalVariable(std::shared_ptr<ir::VariableDeclaration> var
       /*Name=*/name
     );
     gvar->setDSOLocal(true);
+    // note: the transformer only allows constant initializers for thread-local
+    //  variables, the global constructor only runs on the main thread. The
+    //  backend picks the cheapest TLS model for the relocation model in use.
+    if (var->isThreadLocal()) gvar->setThreadLocal(true);
+    ctx->addSymbol(var->getId(), gvar);
+    if (debugVar) gvar->addDebugInfo(debugVar);
+    return;
+  }
+  if (!var->getValue()) {
+    // Uninitialized variables start zeroed (on every thread if they are
+    // thread-local), there's nothing to run in the global constructor.
+    auto gvar = new llvm::GlobalVariable(
+      /*Module=*/*module,
+      /*Type=*/ty,
+      /*isConstant=*/false,
+      /*Linkage=*/llvm::GlobalValue::InternalLinkage,
+      /*Initializer=*/llvm::Constant::getNullValue(ty),
+      /*Name=*/name
+    );
+    gvar->setDSOLocal(true);
+    if (var->isThreadLocal()) gvar->setThreadLocal(true);
     ctx->addSymbol(var->getId(), gvar);
-    gvar->addDebugInfo(debugVar);
+    if (debugVar) gvar->addDebugInfo(debugVar);
     return;
   }
   auto ctor = getGlobalCTOR();
@@ -62,12 +87,13 @@ void LLVMBuilder::addGlobalVariable(std::shared_ptr<ir::VariableDeclaration> var
     /*Name=*/name
   );
   gvar->setDSOLocal(true);
+  if (var->isThreadLocal()) gvar->setThreadLocal(true);
   ctx->addSymbol(var->getId(), gvar);
   ctx->setCurrentFunction(ctor);
   auto val = expr(var->getValue().get());
   builder->CreateStore(val, gvar);
   ctx->clearCurrentFunction();
-  gvar->addDebugInfo(debugVar);
+  if (debugVar) gvar->addDebugInfo(debugVar);
 }
 
 } // namespace codegen
@@ -0,0 +1,71 @@
+#include "../../ir/values/Await.h"
+#include "../../utils/utils.h"
+#include "LLVMBuilder.h"
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Type.h>
+#include <llvm/IR/Value.h>
+
+namespace snowball {
+namespace codegen {
+
+void LLVMBuilder::visit(ir::Await* await) {
+  assert(ctx->getCurrentIRFunction()->isCoroutine());
+  auto futureValue = await->getFuture();
+  auto futureType = utils::cast<types::BaseType>(futureValue->getType());
+  assert(futureType);
+  auto handleIndex = ctx->typeInfo.at(futureType->getId())->hasVtable;
+  auto future = expr(futureValue.get());
+  llvm::Value* handle = nullptr;
+  if (llvm::isa<llvm::LoadInst>(future)) {
+    auto gep = builder->CreateStructGEP(
+                 getLLVMType(futureType), llvm::cast<llvm::LoadInst>(future)->getPointerOperand(), handleIndex
+               );
+    handle = builder->CreateLoad(builder->getPtrTy(), gep, ".coro.handle");
+  } else {
+    handle = builder->CreateExtractValue(future, {handleIndex}, ".coro.handle");
+  }
+  // The awaited coroutine is resumed until it finishes, every time it
+  // suspends we suspend too so the executor driving us gets control back.
+  auto function = ctx->getCurrentFunction();
+  auto resumeBlock = llvm::BasicBlock::Create(*context, "await.resume", function);
+  auto suspendBlock = llvm::BasicBlock::Create(*context, "await.suspend", function);
+  auto destroyBlock = llvm::BasicBlock::Create(*context, "await.destroy", function);
+  auto readyBlock = llvm::BasicBlock::Create(*context, "await.ready", function);
+  builder->CreateCondBr(builder->CreateIntrinsic(llvm::Intrinsic::coro_done, {}, {handle}), readyBlock, resumeBlock);
+  builder->SetInsertPoint(resumeBlock);
+  builder->CreateIntrinsic(llvm::Intrinsic::coro_resume, {}, {handle});
+  builder->CreateCondBr(builder->CreateIntrinsic(llvm::Intrinsic::coro_done, {}, {handle}), readyBlock, suspendBlock);
+  builder->SetInsertPoint(suspendBlock);
+  createCoroutineSuspend(resumeBlock, destroyBlock);
+  // note: if we are destroyed while waiting, the awaited coroutine goes too
+  builder->SetInsertPoint(destroyBlock);
+  builder->CreateIntrinsic(llvm::Intrinsic::coro_destroy, {}, {handle});
+  builder->CreateBr(ctx->coroutine.cleanupBlock);
+  // mark: ready block
+  builder->SetInsertPoint(readyBlock);
+  auto resultType = await->getType();
+  llvm::Value* result = nullptr;
+  if (!utils::is<types::VoidType>(resultType)) {
+    auto llvmType = getLLVMType(resultType);
+    auto align = module->getDataLayout().getABITypeAlign(llvmType);
+    auto promise = builder->CreateIntrinsic(
+                     llvm::Intrinsic::coro_promise, {}, {handle, builder->getInt32(align.value()), builder->getFalse()}
+                   );
+    if (utils::is<types::BaseType>(resultType)) {
+      // The frame is destroyed right after, so the value is copied out of it
+      result = createAlloca(llvmType, ".await-result");
+      builder->CreateMemCpy(result, align, promise, align, module->getDataLayout().getTypeAllocSize(llvmType));
+    } else {
+      result = builder->CreateAlignedLoad(llvmType, promise, align, ".await-result");
+    }
+  }
+  // Awaiting consumes the future, its frame is freed here.
+  builder->CreateIntrinsic(llvm::Intrinsic::coro_destroy, {}, {handle});
+  this->value = result;
+  if (result && !utils::is<types::BaseType>(resultType)) ctx->doNotLoadInMemory = true;
+}
+
+} // namespace codegen
+} // namespace snowball
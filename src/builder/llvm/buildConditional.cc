@@ -1,7 +1,9 @@
 #include "../../ir/values/Conditional.h"
+#include "../../ir/values/Throw.h"
 #include "../../utils/utils.h"
 #include "LLVMBuilder.h"
 
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
@@ -11,6 +13,15 @@
 namespace snowball {
 namespace codegen {
 
+namespace {
+/// @return Whether the block always ends up throwing an exception
+bool alwaysThrows(std::shared_ptr<ir::Block> block) {
+  if (!block) return false;
+  auto insts = block->getBlock();
+  return !insts.empty() && utils::is<ir::Throw>(insts.back().get());
+}
+} // namespace
+
 void LLVMBuilder::visit(ir::Conditional* c) {
   auto parent = ctx->getCurrentFunction();
   assert(parent);
@@ -18,7 +29,15 @@ void LLVMBuilder::visit(ir::Conditional* c) {
   auto falseBB = h.create<llvm::BasicBlock>(*context, "cond.else", parent);
   auto continueBB = h.create<llvm::BasicBlock>(*context, "cond.cont", parent);
   auto cond = expr(c->getCondition().get());
-  createCondBr(cond, trueBB, falseBB);
+  // Error branches (e.g. bounds checks) are marked as unlikely, the weights
+  // are the same ones clang uses for __builtin_expect.
+  llvm::MDNode* weights = nullptr;
+  if (alwaysThrows(c->getBlock())) {
+    weights = llvm::MDBuilder(*context).createBranchWeights(1, 2000);
+  } else if (alwaysThrows(c->getElse())) {
+    weights = llvm::MDBuilder(*context).createBranchWeights(2000, 1);
+  }
+  createCondBr(cond, trueBB, falseBB, weights);
   builder->SetInsertPoint(trueBB);
   build(c->getBlock().get());
   CREATE_CONTINUE(false)
@@ -0,0 +1,98 @@
+#include "../../ir/values/Func.h"
+#include "../../utils/utils.h"
+#include "LLVMBuilder.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Type.h>
+#include <llvm/IR/Value.h>
+
+namespace snowball {
+namespace codegen {
+
+void LLVMBuilder::buildCoroutinePrologue(llvm::Function* llvmFn, ir::Func* fn, llvm::BasicBlock* body) {
+  assert(fn->isCoroutine());
+  llvmFn->setPresplitCoroutine();
+  auto& layout = module->getDataLayout();
+  auto null = llvm::ConstantPointerNull::get(builder->getPtrTy());
+  // The promise is where the coroutine leaves the value it produces, it's part
+  // of the frame so `sn.coro.promise` must use the same alignment.
+  llvm::Value* promise = null;
+  unsigned promiseAlign = 0;
+  if (!utils::is<types::VoidType>(fn->getCoroutineResultType())) {
+    auto promiseType = getLLVMType(fn->getCoroutineResultType());
+    auto alloca = builder->CreateAlloca(promiseType, nullptr, ".coro.promise");
+    alloca->setAlignment(layout.getABITypeAlign(promiseType));
+    promise = alloca;
+    promiseAlign = alloca->getAlign().value();
+  }
+  auto id = builder->CreateIntrinsic(llvm::Intrinsic::coro_id, {}, {builder->getInt32(promiseAlign), promise, null, null});
+  auto needsAlloc = builder->CreateIntrinsic(llvm::Intrinsic::coro_alloc, {}, {id});
+  auto entryBlock = builder->GetInsertBlock();
+  auto allocBlock = llvm::BasicBlock::Create(*context, "coro.alloc", llvmFn, body);
+  auto beginBlock = llvm::BasicBlock::Create(*context, "coro.begin", llvmFn, body);
+  // note: `coro.alloc` is false when the frame is elided into the caller's stack
+  builder->CreateCondBr(needsAlloc, allocBlock, beginBlock);
+  builder->SetInsertPoint(allocBlock);
+  auto size = builder->CreateIntrinsic(llvm::Intrinsic::coro_size, {builder->getInt32Ty()}, {});
+  auto memory = builder->CreateCall(getAllocaFunction(), {size});
+  builder->CreateBr(beginBlock);
+  builder->SetInsertPoint(beginBlock);
+  auto frame = builder->CreatePHI(builder->getPtrTy(), 2);
+  frame->addIncoming(null, entryBlock);
+  frame->addIncoming(memory, allocBlock);
+  auto handle = builder->CreateIntrinsic(llvm::Intrinsic::coro_begin, {}, {id, frame});
+  // The future returned to the caller only holds the handle of the frame
+  auto futureType = utils::cast<types::BaseType>(fn->getRetTy());
+  assert(futureType);
+  auto handleIndex = ctx->typeInfo.at(futureType->getId())->hasVtable;
+  builder->CreateStore(handle, builder->CreateStructGEP(getLLVMType(futureType), llvmFn->getArg(0), handleIndex));
+  ctx->coroutine.id = id;
+  ctx->coroutine.handle = handle;
+  ctx->coroutine.promise = utils::is<types::VoidType>(fn->getCoroutineResultType()) ? nullptr : promise;
+  ctx->coroutine.cleanupBlock = llvm::BasicBlock::Create(*context, "coro.cleanup", llvmFn);
+  ctx->coroutine.suspendBlock = llvm::BasicBlock::Create(*context, "coro.suspend", llvmFn);
+  ctx->coroutine.finalBlock = llvm::BasicBlock::Create(*context, "coro.final", llvmFn);
+  auto freeBlock = llvm::BasicBlock::Create(*context, "coro.free", llvmFn);
+  // mark: initial suspension point
+  createCoroutineSuspend(body);
+  // mark: cleanup block
+  builder->SetInsertPoint(ctx->coroutine.cleanupBlock);
+  auto memoryToFree = builder->CreateIntrinsic(llvm::Intrinsic::coro_free, {}, {id, handle});
+  builder->CreateCondBr(builder->CreateIsNotNull(memoryToFree), freeBlock, ctx->coroutine.suspendBlock);
+  builder->SetInsertPoint(freeBlock);
+  auto freeType = llvm::FunctionType::get(builder->getVoidTy(), {builder->getPtrTy()}, false);
+  builder->CreateCall(module->getOrInsertFunction("free", freeType), {memoryToFree});
+  builder->CreateBr(ctx->coroutine.suspendBlock);
+  // mark: suspend block
+  builder->SetInsertPoint(ctx->coroutine.suspendBlock);
+  auto coroEnd = llvm::Intrinsic::getDeclaration(module.get(), llvm::Intrinsic::coro_end);
+  std::vector<llvm::Value*> endArgs = {handle, builder->getFalse()};
+  // note: newer LLVM versions also take the values returned on unwind
+  if (coroEnd->arg_size() == 3) endArgs.push_back(llvm::ConstantTokenNone::get(*context));
+  builder->CreateCall(coroEnd, endArgs);
+  builder->CreateRetVoid();
+  // mark: final suspension point
+  // Finished coroutines stay suspended here until their owner destroys them,
+  // resuming them is undefined behaviour.
+  builder->SetInsertPoint(ctx->coroutine.finalBlock);
+  auto finishedBlock = llvm::BasicBlock::Create(*context, "coro.finished", llvmFn);
+  createCoroutineSuspend(finishedBlock, nullptr, true);
+  builder->SetInsertPoint(finishedBlock);
+  builder->CreateUnreachable();
+}
+
+void LLVMBuilder::createCoroutineSuspend(llvm::BasicBlock* resume, llvm::BasicBlock* destroy, bool isFinal) {
+  assert(ctx->coroutine.id != nullptr);
+  auto state = builder->CreateIntrinsic(
+                 llvm::Intrinsic::coro_suspend, {}, {llvm::ConstantTokenNone::get(*context), builder->getInt1(isFinal)}
+               );
+  // -1 = suspended, 0 = resumed, 1 = destroyed
+  auto dispatch = builder->CreateSwitch(state, ctx->coroutine.suspendBlock, 2);
+  dispatch->addCase(builder->getInt8(0), resume);
+  dispatch->addCase(builder->getInt8(1), destroy ? destroy : ctx->coroutine.cleanupBlock);
+}
+
+} // namespace codegen
+} // namespace snowball
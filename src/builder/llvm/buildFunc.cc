@@ -156,27 +156,29 @@ llvm::Function* LLVMBuilder::buildBodiedFunction(llvm::Function* llvmFn, ir::Fun
       selfArgVal = varIter->second;
     }
     // debug info
-    auto src = var->getSourceInfo();
-    auto dbgInfo = var->getDBGInfo();
-    auto file = dbg.getFile(src->getPath());
-    auto scope = llvmFn->getSubprogram();
-    auto debugVar = dbg.builder->createParameterVariable(
-                      scope,
-                      var->getIdentifier(),
-                      var->getIndex() + 1 + retIsArg + anon, // lua vibes... :]
-                      file,
-                      dbgInfo->line,
-                      getDIType(var->getType()),
-                      dbg.debug,
-                      llvm::DINode::FlagArtificial | llvm::DINode::FlagObjectPointer
-                    );
-    dbg.builder->insertDeclare(
-      storage,
-      debugVar,
-      dbg.builder->createExpression(),
-      llvm::DILocation::get(*context, dbgInfo->line, dbgInfo->pos.second, scope),
-      entry
-    );
+    if (dbg.variables()) {
+      auto src = var->getSourceInfo();
+      auto dbgInfo = var->getDBGInfo();
+      auto file = dbg.getFile(src->getPath());
+      auto scope = llvmFn->getSubprogram();
+      auto debugVar = dbg.builder->createParameterVariable(
+                        scope,
+                        var->getIdentifier(),
+                        var->getIndex() + 1 + retIsArg + anon, // lua vibes... :]
+                        file,
+                        dbgInfo->line,
+                        getDIType(var->getType()),
+                        dbg.debug,
+                        llvm::DINode::FlagArtificial | llvm::DINode::FlagObjectPointer
+                      );
+      dbg.builder->insertDeclare(
+        storage,
+        debugVar,
+        dbg.builder->createExpression(),
+        llvm::DILocation::get(*context, dbgInfo->line, dbgInfo->pos.second, scope),
+        entry
+      );
+    }
     ++llvmArgsIter;
   }
   // Generate all the used variables
@@ -237,7 +239,11 @@ llvm::Function* LLVMBuilder::buildBodiedFunction(llvm::Function* llvmFn, ir::Fun
       builder->CreateStore(vtablePointer, vtableSpot);
     }
   }
-  builder->CreateBr(body);
+  if (fn->isCoroutine()) {
+    buildCoroutinePrologue(llvmFn, fn, body);
+  } else {
+    builder->CreateBr(body);
+  }
   // mark: body block
   builder->SetInsertPoint(body);
   // Codegen for the current body
@@ -245,7 +251,9 @@ llvm::Function* LLVMBuilder::buildBodiedFunction(llvm::Function* llvmFn, ir::Fun
   setDebugInfoLoc(nullptr);
   // Create return type
   if (!builder->GetInsertBlock()->getTerminator()) {
-    if (utils::cast<types::VoidType>(fn->getRetTy()) || utils::cast<types::BaseType>(fn->getRetTy())) {
+    if (fn->isCoroutine()) {
+      builder->CreateBr(ctx->coroutine.finalBlock);
+    } else if (utils::cast<types::VoidType>(fn->getRetTy()) || utils::cast<types::BaseType>(fn->getRetTy())) {
       builder->CreateRetVoid();
     } else if (fn->isConstructor()) {
       // note: 0 should be always the "self" parameter
@@ -257,6 +265,7 @@ llvm::Function* LLVMBuilder::buildBodiedFunction(llvm::Function* llvmFn, ir::Fun
     }
   }
   // mark: clean up
+  ctx->coroutine = {};
   ctx->clearCurrentFunction();
   ctx->clearCurrentIRFunction();
   auto DISubprogram = llvmFn->getSubprogram();
@@ -5,12 +5,64 @@
 #include "../../utils/utils.h"
 #include "LLVMBuilder.h"
 
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
 namespace snowball {
 namespace codegen {
 
+namespace {
+/// @brief LLVM orderings, indexed by the values used in `std::atomic`
+const llvm::AtomicOrdering atomicOrderings[] = {
+  llvm::AtomicOrdering::Monotonic, llvm::AtomicOrdering::Acquire, llvm::AtomicOrdering::Release,
+  llvm::AtomicOrdering::AcquireRelease, llvm::AtomicOrdering::SequentiallyConsistent
+};
+const char* atomicOrderingNames[] = {"relaxed", "acquire", "release", "acq_rel", "seq_cst"};
+
+/// @return The read-modify-write operation for an intrinsic (BAD_BINOP if it's not one)
+llvm::AtomicRMWInst::BinOp getAtomicBinOp(const std::string& name) {
+  if (name == "sn.atomic.swap") return llvm::AtomicRMWInst::Xchg;
+  if (name == "sn.atomic.fetch_add") return llvm::AtomicRMWInst::Add;
+  if (name == "sn.atomic.fetch_sub") return llvm::AtomicRMWInst::Sub;
+  if (name == "sn.atomic.fetch_and") return llvm::AtomicRMWInst::And;
+  if (name == "sn.atomic.fetch_or") return llvm::AtomicRMWInst::Or;
+  if (name == "sn.atomic.fetch_xor") return llvm::AtomicRMWInst::Xor;
+  return llvm::AtomicRMWInst::BAD_BINOP;
+}
+} // namespace
+
+llvm::Value* LLVMBuilder::buildAtomicOrdering(
+  llvm::Value* order, llvm::Type* resultType, std::function<llvm::Value*(llvm::AtomicOrdering)> emit
+) {
+  constexpr unsigned count = sizeof(atomicOrderings) / sizeof(atomicOrderings[0]);
+  if (auto constant = llvm::dyn_cast<llvm::ConstantInt>(order)) {
+    auto index = constant->getZExtValue();
+    // Unknown orderings are treated as the strongest one
+    return emit(index < count ? atomicOrderings[index] : llvm::AtomicOrdering::SequentiallyConsistent);
+  }
+  auto function = builder->GetInsertBlock()->getParent();
+  auto end = llvm::BasicBlock::Create(*context, "atomic.end", function);
+  auto fallback = llvm::BasicBlock::Create(*context, "atomic.seq_cst", function);
+  auto orderType = llvm::cast<llvm::IntegerType>(order->getType());
+  auto dispatch = builder->CreateSwitch(order, fallback, count - 1);
+  builder->SetInsertPoint(end);
+  auto phi = resultType ? builder->CreatePHI(resultType, count) : nullptr;
+  for (unsigned i = 0; i < count; i++) {
+    auto block = i == count - 1 ? fallback :
+                 llvm::BasicBlock::Create(*context, std::string("atomic.") + atomicOrderingNames[i], function, end);
+    if (i != count - 1) dispatch->addCase(llvm::ConstantInt::get(orderType, i), block);
+    builder->SetInsertPoint(block);
+    auto result = emit(atomicOrderings[i]);
+    if (phi) phi->addIncoming(result, builder->GetInsertBlock());
+    builder->CreateBr(end);
+  }
+  fallback->moveBefore(end);
+  builder->SetInsertPoint(end);
+  return phi;
+}
+
 bool LLVMBuilder::buildIntrinsic(ir::Call* call) {
   auto callee = utils::dyn_cast<ir::Func>(call->getCallee());
   if (!callee) return false;
@@ -44,6 +96,110 @@ bool LLVMBuilder::buildIntrinsic(ir::Call* call) {
   } else if (name == "sn.debugbreak") {
     assert(args.size() == 0);
     builder->CreateIntrinsic(llvm::Intrinsic::debugtrap, {}, {});
+  } else if (name == "sn.cycles") {
+    assert(args.size() == 0);
+    // note: `rdtsc` on x86, the virtual counter on aarch64 (0 where there's none)
+    auto cycles = builder->CreateIntrinsic(llvm::Intrinsic::readcyclecounter, {}, {});
+    this->value = builder->CreateZExtOrTrunc(cycles, getLLVMType(call->getType()));
+  } else if (name == "sn.atomic.load") {
+    assert(args.size() == 2);
+    auto ptr = expr(args[0].get());
+    auto order = expr(args[1].get());
+    auto type = getLLVMType(call->getType());
+    auto align = llvm::Align(module->getDataLayout().getTypeStoreSize(type));
+    this->value = buildAtomicOrdering(order, type, [&](llvm::AtomicOrdering ordering) -> llvm::Value* {
+      // Loads can't release, keep the acquire part of the ordering
+      if (ordering == llvm::AtomicOrdering::Release) ordering = llvm::AtomicOrdering::Monotonic;
+      else if (ordering == llvm::AtomicOrdering::AcquireRelease) ordering = llvm::AtomicOrdering::Acquire;
+      auto load = builder->CreateAlignedLoad(type, ptr, align);
+      load->setAtomic(ordering);
+      return load;
+    });
+  } else if (name == "sn.atomic.store") {
+    assert(args.size() == 3);
+    auto ptr = expr(args[0].get());
+    auto value = expr(args[1].get());
+    auto order = expr(args[2].get());
+    auto align = llvm::Align(module->getDataLayout().getTypeStoreSize(value->getType()));
+    buildAtomicOrdering(order, nullptr, [&](llvm::AtomicOrdering ordering) -> llvm::Value* {
+      // Stores can't acquire, keep the release part of the ordering
+      if (ordering == llvm::AtomicOrdering::Acquire) ordering = llvm::AtomicOrdering::Monotonic;
+      else if (ordering == llvm::AtomicOrdering::AcquireRelease) ordering = llvm::AtomicOrdering::Release;
+      auto store = builder->CreateAlignedStore(value, ptr, align);
+      store->setAtomic(ordering);
+      return nullptr;
+    });
+  } else if (auto op = getAtomicBinOp(name); op != llvm::AtomicRMWInst::BAD_BINOP) {
+    assert(args.size() == 3);
+    auto ptr = expr(args[0].get());
+    auto value = expr(args[1].get());
+    auto order = expr(args[2].get());
+    if (op != llvm::AtomicRMWInst::Xchg && !value->getType()->isIntegerTy()) {
+      Syntax::E<TYPE_ERROR>(call, FMT("Atomic operation '%s' can only be used with integer types!", name.c_str()), {
+        .info = FMT("This value has type '%s'", args[1]->getType()->getPrettyName().c_str()),
+        .help = "Use 'swap' or 'compare_exchange' for pointers."
+      });
+    }
+    auto align = llvm::Align(module->getDataLayout().getTypeStoreSize(value->getType()));
+    this->value = buildAtomicOrdering(order, value->getType(), [&](llvm::AtomicOrdering ordering) -> llvm::Value* {
+      return builder->CreateAtomicRMW(op, ptr, value, align, ordering);
+    });
+  } else if (name == "sn.atomic.cmpxchg" || name == "sn.atomic.cmpxchg_weak") {
+    assert(args.size() == 4);
+    auto ptr = expr(args[0].get());
+    auto expectedPtr = expr(args[1].get());
+    auto desired = expr(args[2].get());
+    auto order = expr(args[3].get());
+    auto type = desired->getType();
+    auto align = llvm::Align(module->getDataLayout().getTypeStoreSize(type));
+    auto expected = builder->CreateAlignedLoad(type, expectedPtr, align);
+    auto result = buildAtomicOrdering(order, builder->getInt1Ty(), [&](llvm::AtomicOrdering ordering) -> llvm::Value* {
+      auto failure = llvm::AtomicCmpXchgInst::getStrongestFailureOrdering(ordering);
+      auto cmpxchg = builder->CreateAtomicCmpXchg(ptr, expected, desired, align, ordering, failure);
+      cmpxchg->setWeak(name == "sn.atomic.cmpxchg_weak");
+      // The current value is written back so callers can retry with it
+      builder->CreateAlignedStore(builder->CreateExtractValue(cmpxchg, 0), expectedPtr, align);
+      return builder->CreateExtractValue(cmpxchg, 1);
+    });
+    this->value = builder->CreateZExt(result, getLLVMType(call->getType()));
+  } else if (name == "sn.atomic.fence") {
+    assert(args.size() == 1);
+    auto order = expr(args[0].get());
+    buildAtomicOrdering(order, nullptr, [&](llvm::AtomicOrdering ordering) -> llvm::Value* {
+      // note: relaxed fences don't order anything (and aren't valid IR)
+      if (ordering != llvm::AtomicOrdering::Monotonic) builder->CreateFence(ordering);
+      return nullptr;
+    });
+  } else if (name == "sn.coro.resume") {
+    assert(args.size() == 1);
+    builder->CreateIntrinsic(llvm::Intrinsic::coro_resume, {}, {expr(args[0].get())});
+  } else if (name == "sn.coro.destroy") {
+    assert(args.size() == 1);
+    builder->CreateIntrinsic(llvm::Intrinsic::coro_destroy, {}, {expr(args[0].get())});
+  } else if (name == "sn.coro.done") {
+    assert(args.size() == 1);
+    auto done = builder->CreateIntrinsic(llvm::Intrinsic::coro_done, {}, {expr(args[0].get())});
+    this->value = builder->CreateZExt(done, getLLVMType(call->getType()));
+  } else if (name == "sn.coro.promise") {
+    assert(args.size() == 1);
+    auto pointer = utils::cast<types::PointerType>(call->getType());
+    assert(pointer);
+    // note: it has to match the alignment of the promise created by `buildCoroutinePrologue`
+    auto align = module->getDataLayout().getABITypeAlign(getLLVMType(pointer->getPointedType()));
+    this->value = builder->CreateIntrinsic(
+                    llvm::Intrinsic::coro_promise, {}, {expr(args[0].get()), builder->getInt32(align.value()), builder->getFalse()}
+                  );
+  } else if (name == "sn.coro.suspend") {
+    assert(args.size() == 0);
+    if (!ctx->getCurrentIRFunction()->isCoroutine()) {
+      Syntax::E<SYNTAX_ERROR>(call, "Only async functions can be suspended!", {
+        .info = "The current function is not a coroutine",
+        .help = "Declare the function as 'async' or use 'await coro::yield_now()' inside one."
+      });
+    }
+    auto resume = llvm::BasicBlock::Create(*context, "coro.resume", ctx->getCurrentFunction());
+    createCoroutineSuspend(resume);
+    builder->SetInsertPoint(resume);
   } else Syntax::E<BUG>(call, FMT("unknown intrinsic: %s", name.c_str()));
   return true;
 }
@@ -7,6 +7,8 @@
 #include "../../utils/utils.h"
 #include "LLVMBuilder.h"
 
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
@@ -18,6 +20,45 @@ using namespace utils;
 void LLVMBuilder::visit(ir::Return* ret) {
   auto exprValue = ret->getExpr();
   llvm::Value* val = nullptr;
+  if (ctx->getCurrentIRFunction()->isCoroutine()) {
+    // Coroutines leave the value in their promise and wait at the final
+    // suspension point until their owner reads it.
+    if (exprValue != nullptr) {
+      assert(ctx->coroutine.promise != nullptr);
+      if (is<types::BaseType>(ret->getType())) {
+        auto e = build(exprValue.get());
+        if (llvm::isa<llvm::LoadInst>(e)) { e = llvm::cast<llvm::LoadInst>(e)->getPointerOperand(); }
+        auto size = module->getDataLayout().getTypeAllocSize(getLLVMType(ret->getType()));
+        builder->CreateMemCpy(ctx->coroutine.promise, llvm::MaybeAlign(), e, llvm::MaybeAlign(), size);
+      } else {
+        builder->CreateStore(expr(exprValue.get()), ctx->coroutine.promise);
+      }
+    }
+    this->value = builder->CreateBr(ctx->coroutine.finalBlock);
+    return;
+  }
+  auto tailCall = utils::dyn_cast<ir::Call>(exprValue);
+  if (tailCall && !tailCall->isTailCall) tailCall = nullptr;
+  if (tailCall) {
+    if (is<types::VoidType>(ret->getType())) {
+      build(exprValue.get());
+      setMustTailCall(tailCall.get(), nullptr);
+      this->value = builder->CreateRetVoid();
+      return;
+    } else if (is<types::BaseType>(ret->getType())) {
+      // The callee writes the result straight into our own return slot
+      ctx->retValueUsedFromArg = true;
+      build(exprValue.get());
+      ctx->retValueUsedFromArg = false;
+      setMustTailCall(tailCall.get(), nullptr);
+      this->value = builder->CreateRetVoid();
+      return;
+    }
+    auto e = expr(exprValue.get());
+    setMustTailCall(tailCall.get(), e);
+    this->value = builder->CreateRet(e);
+    return;
+  }
   if (exprValue != nullptr) {
     // case: "let a = x();" where x is a function returning a type that's not a pointer
     // We store the value into the first argument of the function.
@@ -60,5 +101,64 @@ void LLVMBuilder::visit(ir::Return* ret) {
   this->value = val;
 }
 
+void LLVMBuilder::setMustTailCall(ir::Call* call, llvm::Value* result) {
+  auto block = builder->GetInsertBlock();
+  auto inst = block->empty() ? nullptr : llvm::dyn_cast<llvm::CallInst>(&block->back());
+  if (!inst) {
+    if (!tryCatchStack.empty()) {
+      Syntax::E<SYNTAX_ERROR>(call, "Tail calls can't be used inside a try block!",
+                              {.info = "The call may throw an exception that has to be catched by this function",
+                               .help = "Move the call outside of the try block or remove the '@tail' attribute"});
+    }
+    Syntax::E<SYNTAX_ERROR>(call, "This call can't be a tail call!",
+                            {.info = "It does not generate a function call (e.g. it's a builtin operator)",
+                             .help = "Remove the '@tail' attribute"});
+  }
+  if (result != nullptr && result != inst) {
+    Syntax::E<SYNTAX_ERROR>(call, "This call can't be a tail call!",
+                            {.info = "The returned value has to be converted after the call",
+                             .help = "Remove the '@tail' attribute"});
+  }
+  auto caller = ctx->getCurrentFunction();
+  auto callerType = caller->getFunctionType();
+  auto calleeType = inst->getFunctionType();
+  auto prototypesMatch = callerType == calleeType && caller->getCallingConv() == inst->getCallingConv();
+  // Attributes that change how arguments are passed must also match
+  static const llvm::Attribute::AttrKind abiAttributes[] = {
+    llvm::Attribute::StructRet, llvm::Attribute::ByVal,     llvm::Attribute::InAlloca,
+    llvm::Attribute::InReg,     llvm::Attribute::SwiftSelf, llvm::Attribute::SwiftError,
+  };
+  for (unsigned i = 0; prototypesMatch && i < calleeType->getNumParams(); i++) {
+    for (auto kind : abiAttributes) {
+      if (caller->getArg(i)->hasAttribute(kind) != inst->paramHasAttr(i, kind)) prototypesMatch = false;
+    }
+  }
+  if (!prototypesMatch) {
+    Syntax::E<TYPE_ERROR>(
+      call,
+      "This call can't be a tail call!",
+      {.info = "The called function does not have the same signature as the current function",
+       .note = "Guaranteed tail calls reuse the stack frame of the caller, so both\n"
+               "functions must take the same arguments and return the same type.",
+       .help = "Make both functions take the same arguments (e.g. by passing an\n"
+               "accumulator) or remove the '@tail' attribute"}
+    );
+  }
+  for (auto& arg : inst->args()) {
+    if (!arg->getType()->isPointerTy()) continue;
+    if (llvm::isa<llvm::AllocaInst>(llvm::getUnderlyingObject(arg))) {
+      Syntax::E<SYNTAX_ERROR>(
+        call,
+        "This call can't be a tail call!",
+        {.info = "A pointer to a local value of the current function is passed to it",
+         .note = "The stack frame of the current function is reused by the called\n"
+                 "function, so its local values no longer exist during the call.",
+         .help = "Pass the value itself or remove the '@tail' attribute"}
+      );
+    }
+  }
+  inst->setTailCallKind(llvm::CallInst::TCK_MustTail);
+}
+
 } // namespace codegen
 } // namespace snowball
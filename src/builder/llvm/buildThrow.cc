@@ -13,9 +13,14 @@ namespace codegen {
 void LLVMBuilder::visit(ir::Throw* extract) {
   auto expr = extract->getExpr();
   auto value = build(expr.get());
-  auto exception = createException(value, expr->getType());
-  auto[type, throwFunction] = getThrowFunction();
-  this->value = createCall(type, throwFunction, {exception});
+  // Creating and throwing the exception happens in an outlined cold
+  // function, only a single call is left next to the hot path.
+  auto throwFunction = getColdThrowFunction(expr->getType());
+  auto exception = builder->CreatePointerCast(value, builder->getInt8PtrTy());
+  this->value = createCall(throwFunction->getFunctionType(), throwFunction, {exception});
+  builder->CreateUnreachable();
+  // Anything generated after the throw is dead code
+  builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "throw.dead", ctx->getCurrentFunction()));
 }
 
 } // namespace codegen
@@ -65,14 +65,13 @@ void LLVMBuilder::visit(ir::TryCatch* node) {
     auto varName = "snowball.typeidx." + catchVar->getType()->getMangledName();
     llvm::GlobalVariable* tidx = module->getGlobalVariable(varName);
     if (!tidx) {
+      auto [id, end] = getClassIdRange(catchVar->getType());
       tidx = new llvm::GlobalVariable(
         *module,
-        llvm::StructType::get(builder->getInt32Ty()),
+        getTypeInfoType(),
         /*isConstant=*/true,
         llvm::GlobalValue::PrivateLinkage,
-        llvm::ConstantStruct::get(
-          getTypeInfoType(), builder->getInt32(typeIdxLookup(catchVar->getType()->getMangledName()))
-        ),
+        llvm::ConstantStruct::get(getTypeInfoType(), {builder->getInt32(id), builder->getInt32(end)}),
         varName
       );
       tidx->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
@@ -111,21 +110,26 @@ void LLVMBuilder::visit(ir::TryCatch* node) {
   auto objType = builder->CreateExtractValue(loadedExc, 0);
   objType = builder->CreateExtractValue(objType, 0);
   auto objPtr = builder->CreateExtractValue(loadedExc, 1);
-  auto defaultRouteBlock = llvm::BasicBlock::Create(*context, "trycatch.fdepth", parentFunc);
-  builder->SetInsertPoint(defaultRouteBlock);
-  builder->CreateBr(endBlock);
-  builder->SetInsertPoint(info.catchRouteBlock);
-  auto castSwitch = builder->CreateSwitch(objType, defaultRouteBlock, (unsigned) catchInstances.size());
   // TODO: support for "catch all"
   for (int i = 0; i < (int)info.handlers.size(); i++) {
-    // set finally depth
-    auto mangledType = catchVars[i]->getType()->getMangledName();
+    // Handlers are checked in order, the first one whose class is the
+    // thrown class (or one of its parents) gets the exception.
+    // note: `id <= thrown < end` is checked as `thrown - id <u end - id`
+    auto [id, end] = getClassIdRange(catchVars[i]->getType());
+    auto nextRouteBlock = llvm::BasicBlock::Create(*context, "catch.route.next", parentFunc);
+    auto offset = builder->CreateSub(objType, builder->getInt32(id));
+    createCondBr(builder->CreateICmpULT(offset, builder->getInt32(end - id)), info.handlers[i], nextRouteBlock);
+    builder->SetInsertPoint(nextRouteBlock);
+  }
+  // None of the handlers catch the exception, keep unwinding
+  builder->CreateBr(unwindResumeBlock);
+  for (int i = 0; i < (int)info.handlers.size(); i++) {
     auto type = getLLVMType(catchVars[i]->getType());
     auto BBlock = info.handlers[i];
-    // builder->CreateBr((i < info.handlers.size()) ? info.handlers[i] : endBlock);
-    castSwitch->addCase(builder->getInt32((uint64_t) typeIdxLookup(mangledType)), BBlock);
     auto block = catchInstances[i];
     builder->SetInsertPoint(BBlock);
+    // Everything needed has been loaded, the runtime can reuse the record
+    releaseException(unwindException);
     auto var = catchVars[i];
     if (var) {
       auto obj = builder->CreateLoad(type, objPtr);
@@ -36,7 +36,7 @@ void LLVMBuilder::visit(ir::VariableDeclaration* variable) {
     }
   }
   // debug info
-  if (auto llvmFn = ctx->getCurrentFunction()) {
+  if (auto llvmFn = ctx->getCurrentFunction(); llvmFn && dbg.variables()) {
     auto dbgInfo = variable->getDBGInfo();
     auto src = variable->getSourceInfo();
     auto file = dbg.getFile(src->getPath());
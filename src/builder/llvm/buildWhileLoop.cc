@@ -2,12 +2,56 @@
 #include "../../utils/utils.h"
 #include "LLVMBuilder.h"
 
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Metadata.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
 namespace snowball {
 namespace codegen {
 
+namespace {
+/**
+ * @brief Create the `llvm.loop` metadata for the loop attributes
+ *  (`@unroll`, `@vectorize` and `@no_vectorize`).
+ * @return nullptr if the loop has no hints.
+ * @note Attribute arguments are already validated by the transformer.
+ */
+llvm::MDNode* getLoopMetadata(llvm::LLVMContext& context, ir::WhileLoop* c) {
+  std::vector<llvm::Metadata*> hints;
+  auto i1 = llvm::Type::getInt1Ty(context);
+  auto i32 = llvm::Type::getInt32Ty(context);
+  auto hint = [&](const char* name, llvm::Metadata* value = nullptr) {
+    std::vector<llvm::Metadata*> ops = {llvm::MDString::get(context, name)};
+    if (value) ops.push_back(value);
+    hints.push_back(llvm::MDNode::get(context, ops));
+  };
+  auto constant = [&](llvm::Type* ty, uint64_t value) {
+    return llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(ty, value));
+  };
+  if (c->hasAttribute(Attributes::LOOP_UNROLL)) {
+    auto args = c->getAttributeArgs(Attributes::LOOP_UNROLL);
+    if (args.empty()) hint("llvm.loop.unroll.enable");
+    else hint("llvm.loop.unroll.count", constant(i32, std::stoi(args.begin()->first)));
+  }
+  if (c->hasAttribute(Attributes::LOOP_VECTORIZE)) {
+    auto args = c->getAttributeArgs(Attributes::LOOP_VECTORIZE);
+    hint("llvm.loop.vectorize.enable", constant(i1, 1));
+    if (args.count("width")) hint("llvm.loop.vectorize.width", constant(i32, std::stoi(args["width"])));
+    if (args.count("interleave")) hint("llvm.loop.interleave.count", constant(i32, std::stoi(args["interleave"])));
+  } else if (c->hasAttribute(Attributes::LOOP_NO_VECTORIZE)) {
+    hint("llvm.loop.vectorize.enable", constant(i1, 0));
+    hint("llvm.loop.interleave.count", constant(i32, 1));
+  }
+  if (hints.empty()) return nullptr;
+  // Loop IDs are distinct and their first operand points to themselves
+  hints.insert(hints.begin(), nullptr);
+  auto loopID = llvm::MDNode::getDistinct(context, hints);
+  loopID->replaceOperandWith(0, loopID);
+  return loopID;
+}
+} // namespace
+
 void LLVMBuilder::visit(ir::WhileLoop* c) {
   auto parent = ctx->getCurrentFunction();
   assert(parent);
@@ -19,6 +63,7 @@ void LLVMBuilder::visit(ir::WhileLoop* c) {
     .continueBlock = condBB,
     .breakBlock = continueBB,
   };
+  auto entryBB = builder->GetInsertBlock();
   if (c->isDoWhile()) {
     builder->CreateBr(whileBB);
     builder->SetInsertPoint(whileBB);
@@ -59,6 +104,15 @@ void LLVMBuilder::visit(ir::WhileLoop* c) {
     }
   }
   ctx->loop = backupLoop;
+  if (auto loopID = getLoopMetadata(*context, c)) {
+    // Attach the hints to every back edge, "continue" statements may
+    // add more than one latch to the loop.
+    auto header = c->isDoWhile() ? whileBB : condBB;
+    for (auto pred : llvm::predecessors(header)) {
+      if (pred == entryBB) continue;
+      pred->getTerminator()->setMetadata(llvm::LLVMContext::MD_loop, loopID);
+    }
+  }
 }
 
 } // namespace codegen
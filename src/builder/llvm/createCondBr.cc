@@ -11,11 +11,13 @@
 namespace snowball {
 namespace codegen {
 
-void LLVMBuilder::createCondBr(llvm::Value* cond, llvm::BasicBlock* thenBlock, llvm::BasicBlock* elseBlock) {
+void LLVMBuilder::createCondBr(
+  llvm::Value* cond, llvm::BasicBlock* thenBlock, llvm::BasicBlock* elseBlock, llvm::MDNode* weights
+) {
   if (cond->getType()->isIntegerTy(8)) {
     cond = builder->CreateTrunc(cond, builder->getInt1Ty());
   }
-  builder->CreateCondBr(cond, thenBlock, elseBlock);
+  builder->CreateCondBr(cond, thenBlock, elseBlock, weights);
 }
 
 } // namespace codegen
@@ -18,10 +18,18 @@ llvm::Value* LLVMBuilder::createException(llvm::Value* value, types::Type* type)
   f->addRetAttr(llvm::Attribute::NoUndef);
   f->setDoesNotThrow();
   auto usedValue = value; // use LLVMBuilder::load instead?
-  int typeId = typeIdxLookup(type->getMangledName());
+  int typeId = getClassIdRange(type).first;
   auto cast = builder->CreatePointerCast(usedValue, builder->getInt8PtrTy());
   return builder->CreateCall(f, {cast, builder->getInt32(typeId)});
 }
 
+void LLVMBuilder::releaseException(llvm::Value* exception) {
+  auto ty = llvm::FunctionType::get(builder->getVoidTy(), {builder->getInt8PtrTy()}, false);
+  auto f =
+    llvm::cast<llvm::Function>(module->getOrInsertFunction(getSharedLibraryName("sn.eh.release"), ty).getCallee());
+  f->setDoesNotThrow();
+  builder->CreateCall(f, {exception});
+}
+
 } // namespace codegen
 } // namespace snowball
@@ -2,6 +2,7 @@
 #include "../../ast/errors/error.h"
 #include "../../visitors/Transformer.h"
 #include "../../ir/values/Argument.h"
+#include "../../services/ImportService.h"
 #include "../../utils/utils.h"
 #include "LLVMBuilder.h"
 
@@ -24,6 +25,13 @@ void setDereferenceableAttribute(llvm::Argument& arg, unsigned bytes) {
   arg.addAttr(noundef);
   arg.addAttr(nonull);
 }
+/// @return Whether the type is (or inherits from) the core `Exception` class
+bool isExceptionType(types::Type* type) {
+  for (auto cls = utils::cast<types::DefinedType>(type); cls; cls = cls->getParent()) {
+    if (utils::startsWith(cls->getUUID(), services::ImportService::CORE_UUID + "std.Exception:")) return true;
+  }
+  return false;
+}
 } // namespace
 
 llvm::Function* LLVMBuilder::createLLVMFunction(ir::Func* func) {
@@ -46,6 +54,7 @@ llvm::Function* LLVMBuilder::createLLVMFunction(ir::Func* func) {
               module.get()
             );
   auto callee = (llvm::Function*) fn;
+  if (sizeOptions.report && func->getModule()) functionModules[callee] = func->getModule()->getName();
   auto attrSet = callee->getAttributes();
   if (func->hasAttribute(Attributes::INLINE)) {
     auto newAttrSet = attrSet.addFnAttribute(callee->getContext(), llvm::Attribute::AlwaysInline);
@@ -55,6 +64,8 @@ llvm::Function* LLVMBuilder::createLLVMFunction(ir::Func* func) {
     auto newAttrSet = attrSet.addFnAttribute(callee->getContext(), llvm::Attribute::NoInline);
     callee->setAttributes(newAttrSet);
   }
+  // Exceptions are only constructed on error paths
+  if (func->isConstructor() && isExceptionType(func->getParent())) callee->addFnAttr(llvm::Attribute::Cold);
   if (!func->isDeclaration()) {
     auto DISubprogram = getDISubprogramForFunc(func);
     callee->setSubprogram(DISubprogram);
@@ -68,12 +79,21 @@ llvm::Function* LLVMBuilder::createLLVMFunction(ir::Func* func) {
     attrBuilder.addAttribute(llvm::Attribute::NonNull);
     arg->addAttrs(attrBuilder);
   }
+  // Arguments given to `@restrict` (or all of them if none is given) are
+  // promised by the user to not alias with any other pointer.
+  auto restricted = func->getAttributeArgs(Attributes::RESTRICT);
+  bool restrictAll = func->hasAttribute(Attributes::RESTRICT) && restricted.empty();
   for (int i = 0; i < (int)func->getArgs().size(); ++i) {
     auto llvmArg = fn->arg_begin() + i + retIsArg + func->isAnon();
     auto arg = utils::at(func->getArgs(), i);
     if (auto ref = utils::cast<types::ReferenceType>(arg.second->getType())) {
       setDereferenceableAttribute(*llvmArg, ref->getPointedType()->sizeOf() / 8);
     }
+    auto isPointer = utils::is<types::ReferenceType>(arg.second->getType()) ||
+                     utils::is<types::PointerType>(arg.second->getType());
+    if (isPointer && (restrictAll || restricted.count(arg.first))) {
+      llvmArg->addAttr(llvm::Attribute::NoAlias);
+    }
   }
   return callee;
 }
@@ -12,8 +12,29 @@ namespace codegen {
 std::pair<llvm::FunctionType*, llvm::Function*> LLVMBuilder::getThrowFunction() {
   auto ty = llvm::FunctionType::get(builder->getVoidTy(), {builder->getInt8PtrTy()}, false);
   auto f = llvm::cast<llvm::Function>(module->getOrInsertFunction(getSharedLibraryName("sn.eh.throw"), ty).getCallee());
+  f->setDoesNotReturn();
+  f->addFnAttr(llvm::Attribute::Cold);
   return {ty, f};
 }
 
+llvm::Function* LLVMBuilder::getColdThrowFunction(types::Type* type) {
+  auto name = "sn.throw.cold." + type->getMangledName();
+  if (auto f = module->getFunction(name)) return f;
+  auto ty = llvm::FunctionType::get(builder->getVoidTy(), {builder->getInt8PtrTy()}, false);
+  auto f = llvm::Function::Create(ty, llvm::Function::InternalLinkage, name, module.get());
+  f->addFnAttr(llvm::Attribute::Cold);
+  f->addFnAttr(llvm::Attribute::NoInline);
+  f->setDoesNotReturn();
+  llvm::IRBuilderBase::InsertPointGuard guard(*builder);
+  builder->SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", f));
+  // The function has no debug info, backtraces skip it
+  builder->SetCurrentDebugLocation(llvm::DebugLoc());
+  auto exception = createException(f->getArg(0), type);
+  auto [throwType, throwFunction] = getThrowFunction();
+  builder->CreateCall(throwType, throwFunction, {exception});
+  builder->CreateUnreachable();
+  return f;
+}
+
 } // namespace codegen
 } // namespace snowball
@@ -9,7 +9,9 @@
 namespace snowball {
 namespace codegen {
 
-llvm::StructType* LLVMBuilder::getTypeInfoType() { return llvm::StructType::get(builder->getInt32Ty()); }
+llvm::StructType* LLVMBuilder::getTypeInfoType() {
+  return llvm::StructType::get(builder->getInt32Ty(), builder->getInt32Ty());
+}
 
 } // namespace codegen
 } // namespace snowball
@@ -0,0 +1,44 @@
+#include "../../../utils/utils.h"
+#include "../LLVMBuilder.h"
+
+#include <functional>
+
+namespace snowball {
+namespace codegen {
+
+void LLVMBuilder::assignClassIds() {
+  std::map<std::string, types::DefinedType*> classes;
+  std::function<void(types::DefinedType*)> addClass = [&](types::DefinedType* cls) {
+    if (!cls || !classes.emplace(cls->getMangledName(), cls).second) return;
+    addClass(cls->getParent());
+  };
+  for (auto& [_, type] : ctx->typeInfo) addClass(utils::cast<types::DefinedType>(type.get()));
+  std::map<std::string, std::vector<std::string>> subclasses;
+  std::vector<std::string> roots;
+  for (auto& [name, cls] : classes) {
+    if (auto parent = cls->getParent()) subclasses[parent->getMangledName()].push_back(name);
+    else roots.push_back(name);
+  }
+  // note: 0 is never used as an id
+  int32_t next = 1;
+  std::function<void(const std::string&)> visit = [&](const std::string& name) {
+    auto id = next++;
+    for (auto& subclass : subclasses[name]) visit(subclass);
+    ctx->classIds[name] = {id, next};
+  };
+  for (auto& root : roots) visit(root);
+  ctx->nextClassId = next;
+}
+
+std::pair<int32_t, int32_t> LLVMBuilder::getClassIdRange(types::Type* type) {
+  if (auto ref = utils::cast<types::ReferenceType>(type)) type = ref->getPointedType();
+  else if (auto ptr = utils::cast<types::PointerType>(type)) type = ptr->getPointedType();
+  auto name = type->getMangledName();
+  auto range = ctx->classIds.find(name);
+  if (range != ctx->classIds.end()) return range->second;
+  auto id = ctx->nextClassId++;
+  return ctx->classIds[name] = {id, id + 1};
+}
+
+} // namespace codegen
+} // namespace snowball
@@ -4,6 +4,8 @@
 #include "../LLVMBuilder.h"
 
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/CallingConv.h>
 #include <llvm/IR/Constants.h>
@@ -26,16 +28,21 @@
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/FormattedStream.h>
 #include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/InstCombine/InstCombine.h>
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Scalar/GVN.h>
 #include <llvm/Transforms/Scalar/Reassociate.h>
 
+#include <exception>
+#include <thread>
+
 namespace snowball {
 namespace codegen {
 
-int LLVMBuilder::emitObjectFile(std::string out, bool log, bool object) {
+namespace {
+void emitModuleToFile(llvm::Module& module, llvm::TargetMachine* target, std::string out, bool object) {
   std::error_code EC;
   llvm::raw_fd_ostream dest(out, EC, llvm::sys::fs::OF_None);
   if (EC) { throw SNError(Error::IO_ERROR, FMT("Could not open file: %s", EC.message().c_str())); }
@@ -46,12 +53,65 @@ int LLVMBuilder::emitObjectFile(std::string out, bool log, bool object) {
     remove(out.c_str());
     throw SNError(Error::LLVM_INTERNAL, "TargetMachine can't emit a file of this type");
   }
-  if (log) Logger::success("Snowball project compiled to an object file! ✨\n");
   DEBUG_CODEGEN("Running object pass manager...");
-  pass.run(*module.get());
+  pass.run(module);
   dest.flush();
+}
+} // namespace
+
+int LLVMBuilder::emitObjectFile(std::string out, bool log, bool object) {
+  emitModuleToFile(*module.get(), target, out, object);
+  if (object && sizeOptions.icf) reportFoldedFunctions(out);
+  if (object && sizeOptions.report) reportSize(out);
+  if (log) Logger::success("Snowball project compiled to an object file! ✨\n");
   return EXIT_SUCCESS;
 }
 
+void LLVMBuilder::emitObjectFiles(const std::vector<std::pair<std::string, bool>>& outputs) {
+  if (outputs.size() == 1) {
+    emitObjectFile(outputs[0].first, false, outputs[0].second);
+    return;
+  }
+  auto reportObject = std::find_if(outputs.begin(), outputs.end(), [](auto& output) { return output.second; });
+  // LLVM contexts can't be shared between threads. Each worker parses its own
+  // copy of the (already optimized) module into a fresh context and uses its
+  // own target machine. Handlers are created up front, the snowball modules
+  // they read from aren't touched by the workers.
+  std::vector<std::unique_ptr<llvm::DiagnosticHandler>> handlers;
+  for (size_t i = 0; i < outputs.size(); i++) handlers.push_back(createDiagnosticHandler());
+  llvm::SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream bitcodeStream(bitcode);
+  llvm::WriteBitcodeToFile(*module.get(), bitcodeStream);
+  std::vector<std::thread> workers;
+  std::vector<std::exception_ptr> failures(outputs.size());
+  for (size_t i = 0; i < outputs.size(); i++) {
+    workers.emplace_back([&, i] {
+      try {
+        llvm::LLVMContext workerContext;
+        workerContext.setDiagnosticHandler(std::move(handlers[i]));
+        auto buffer = llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()), "snowball-module");
+        auto clone = llvm::parseBitcodeFile(buffer, workerContext);
+        if (!clone) throw SNError(Error::LLVM_INTERNAL, llvm::toString(clone.takeError()));
+        std::unique_ptr<llvm::TargetMachine> workerTarget(createTargetMachine());
+        emitModuleToFile(**clone, workerTarget.get(), outputs[i].first, outputs[i].second);
+      } catch (...) { failures[i] = std::current_exception(); }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  for (auto& failure : failures) {
+    if (failure) std::rethrow_exception(failure);
+  }
+  if (reportObject != outputs.end() && sizeOptions.icf) reportFoldedFunctions(reportObject->first);
+  if (reportObject != outputs.end() && sizeOptions.report) reportSize(reportObject->first);
+}
+
+void LLVMBuilder::emitBitcode(std::string out) {
+  std::error_code EC;
+  llvm::raw_fd_ostream dest(out, EC, llvm::sys::fs::OF_None);
+  if (EC) { throw SNError(Error::IO_ERROR, FMT("Could not open file: %s", EC.message().c_str())); }
+  llvm::WriteBitcodeToFile(*module.get(), dest);
+  dest.flush();
+}
+
 } // namespace codegen
 } // namespace snowball
@@ -0,0 +1,78 @@
+#include "../../../utils/utils.h"
+#include "../LLVMBuilder.h"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/ValueHandle.h>
+#include <llvm/Transforms/IPO.h>
+
+#include <map>
+
+namespace snowball {
+namespace codegen {
+
+namespace {
+/// @return The function called by a thunk created by MergeFunctions (nullptr if it's not a thunk)
+llvm::Function* getThunkTarget(llvm::Function& f) {
+  if (f.size() != 1) return nullptr;
+  for (auto& inst : f.front()) {
+    if (auto call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+      auto callee = call->getCalledFunction();
+      if (callee && callee != &f && !callee->isIntrinsic()) return callee;
+    }
+  }
+  return nullptr;
+}
+} // namespace
+
+void LLVMBuilder::foldIdenticalFunctions() {
+  struct Candidate {
+    llvm::Function* function;
+    // Follows the function if it gets replaced by an identical one
+    llvm::WeakTrackingVH handle;
+    std::string name;
+    unsigned instructions;
+  };
+  std::vector<Candidate> candidates;
+  for (auto& f : *module) {
+    if (f.isDeclaration()) continue;
+    candidates.push_back({&f, llvm::WeakTrackingVH(&f), f.getName().str(), f.getInstructionCount()});
+  }
+  llvm::legacy::PassManager pm;
+  pm.add(llvm::createMergeFunctionsPass());
+  pm.run(*module);
+  for (auto& candidate : candidates) {
+    auto kept = llvm::dyn_cast_or_null<llvm::Function>(candidate.handle);
+    if (!kept) continue;
+    if (kept != candidate.function) {
+      // The function was erased and its uses now point to an identical one
+      foldedFunctions.push_back({candidate.name, kept->getName().str()});
+    } else if (kept->getInstructionCount() != candidate.instructions) {
+      // The body was replaced with a call to an identical function
+      if (auto target = getThunkTarget(*kept)) foldedFunctions.push_back({candidate.name, target->getName().str()});
+    }
+  }
+}
+
+void LLVMBuilder::reportFoldedFunctions(const std::string& object) {
+  if (foldedFunctions.empty()) {
+    Logger::message("Folded", "no identical functions found");
+    return;
+  }
+  auto sizes = getSymbolSizes(object);
+  uint64_t bytes = 0;
+  for (auto& [folded, kept] : foldedFunctions) {
+    // Thunks are still emitted, only the difference is saved
+    auto thunk = sizes.count(folded) ? sizes[folded] : 0;
+    if (sizes[kept] > thunk) bytes += sizes[kept] - thunk;
+  }
+  Logger::message(
+    "Folded",
+    FMT("%i identical function(s), saving %s%llu bytes%s of machine code", (int) foldedFunctions.size(), BOLD,
+        (unsigned long long) bytes, RESET)
+  );
+}
+
+} // namespace codegen
+} // namespace snowball
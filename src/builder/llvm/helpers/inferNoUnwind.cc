@@ -0,0 +1,84 @@
+#include "../LLVMBuilder.h"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Transforms/Utils/Local.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace snowball {
+namespace codegen {
+
+namespace {
+/// @return Whether calling this instruction could unwind into the caller
+bool mayUnwindThrough(llvm::CallBase* call) {
+  if (call->doesNotThrow() || call->isInlineAsm()) return false;
+  auto callee = call->getCalledFunction();
+  return !callee || !callee->doesNotThrow();
+}
+} // namespace
+
+void LLVMBuilder::inferNoUnwind() {
+  std::set<llvm::Function*> mayUnwind;
+  // callee -> functions calling it
+  std::map<llvm::Function*, std::vector<llvm::Function*>> callers;
+  std::vector<llvm::Function*> worklist;
+  for (auto& f : *module) {
+    if (f.isDeclaration()) {
+      if (!f.doesNotThrow() && mayUnwind.insert(&f).second) worklist.push_back(&f);
+      continue;
+    }
+    bool unwinds = false;
+    for (auto& inst : llvm::instructions(f)) {
+      if (llvm::isa<llvm::ResumeInst>(inst)) {
+        unwinds = true;
+      } else if (auto call = llvm::dyn_cast<llvm::CallBase>(&inst)) {
+        if (call->doesNotThrow() || call->isInlineAsm()) continue;
+        if (auto callee = call->getCalledFunction()) {
+          callers[callee].push_back(&f);
+        } else {
+          // Virtual calls, lambdas and function pointers could call anything
+          unwinds = true;
+        }
+      }
+    }
+    if (unwinds && mayUnwind.insert(&f).second) worklist.push_back(&f);
+  }
+  while (!worklist.empty()) {
+    auto f = worklist.back();
+    worklist.pop_back();
+    for (auto caller : callers[f]) {
+      if (mayUnwind.insert(caller).second) worklist.push_back(caller);
+    }
+  }
+  for (auto& f : *module) {
+    if (f.isDeclaration()) continue;
+    if (!mayUnwind.count(&f)) f.setDoesNotThrow();
+  }
+  // Now that every function is marked, get rid of the exception handling
+  // code that can never be reached.
+  for (auto& f : *module) {
+    if (f.isDeclaration() || !f.hasPersonalityFn()) continue;
+    std::vector<llvm::InvokeInst*> invokes;
+    for (auto& bb : f) {
+      if (auto invoke = llvm::dyn_cast<llvm::InvokeInst>(bb.getTerminator()); invoke && !mayUnwindThrough(invoke))
+        invokes.push_back(invoke);
+    }
+    for (auto invoke : invokes) llvm::changeToCall(invoke);
+    if (!invokes.empty()) llvm::removeUnreachableBlocks(f);
+    bool hasEHPads = false;
+    for (auto& bb : f) {
+      if (bb.isEHPad()) {
+        hasEHPads = true;
+        break;
+      }
+    }
+    if (!hasEHPads) f.setPersonalityFn(nullptr);
+  }
+}
+
+} // namespace codegen
+} // namespace snowball
@@ -4,6 +4,7 @@
 #include "../LLVMBuilder.h"
 
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/CallingConv.h>
@@ -28,33 +29,115 @@
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/FormattedStream.h>
 #include <llvm/Support/Host.h>
+#include <llvm/Support/PGOOptions.h>
+#include <llvm/Transforms/Coroutines/CoroCleanup.h>
+#include <llvm/Transforms/Coroutines/CoroEarly.h>
+#include <llvm/Transforms/Coroutines/CoroSplit.h>
 #include <llvm/Transforms/IPO.h>
+#include <llvm/Transforms/IPO/AlwaysInliner.h>
+#include <llvm/Transforms/IPO/HotColdSplitting.h>
 #include <llvm/Transforms/InstCombine/InstCombine.h>
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Scalar/GVN.h>
 #include <llvm/Transforms/Scalar/Reassociate.h>
 #include <llvm/Transforms/Utils.h>
 
+#include <algorithm>
+#include <map>
+#include <optional>
+
 namespace snowball {
 
 namespace {
-void applyDebugTransformations(llvm::Module* module, bool debug) {
+void applyDebugTransformations(llvm::Module* module, bool debug, bool keepDebugInfo) {
   if (debug) {
-    // remove tail calls and fix linkage for stack traces
+    // keep unwind tables and frame pointers for stack traces
     for (auto& f : *module) {
       //#ifdef __APPLE__
       //f.setLinkage(llvm::GlobalValue::ExternalLinkage);
       //#endif
-      if (!f.hasFnAttribute(llvm::Attribute::AttrKind::AlwaysInline))
-        f.addFnAttr(llvm::Attribute::AttrKind::NoInline);
+      if (f.isDeclaration()) continue;
       f.setUWTableKind(llvm::UWTableKind::Default);
-      f.addFnAttr("no-frame-pointer-elim", "true");
-      f.addFnAttr("no-frame-pointer-elim-non-leaf");
-      f.addFnAttr("no-jump-tables", "false");
+      f.addFnAttr("frame-pointer", "all");
+    }
+  }
+  if (!keepDebugInfo) llvm::StripDebugInfo(*module);
+}
+/**
+ * Remove the ids that follow every `&<length><name>` component of a mangled
+ * name, the name is copied as is so nothing inside it (e.g. `fooCv1`) is
+ * mistaken for an id.
+ */
+std::string stripDisambiguators(llvm::StringRef mangled) {
+  std::string result;
+  size_t i = 0;
+  while (i < mangled.size()) {
+    if (mangled[i] != '&' || i + 1 >= mangled.size() || !llvm::isDigit(mangled[i + 1])) {
+      result += mangled[i++];
+      continue;
+    }
+    size_t start = i++;
+    size_t length = 0;
+    while (i < mangled.size() && llvm::isDigit(mangled[i])) length = length * 10 + (mangled[i++] - '0');
+    i = std::min(i + length, mangled.size());
+    result += mangled.slice(start, i);
+    // note: functions and classes are followed by `Cv<id>`, enums by `Ev<id>`
+    if (mangled.substr(i).startswith("Cv") || mangled.substr(i).startswith("Ev")) {
+      result += mangled.substr(i, 2);
+      i += 2;
+      while (i < mangled.size() && llvm::isDigit(mangled[i])) i++;
     }
-  } else {
-    llvm::StripDebugInfo(*module);
   }
+  return result;
+}
+/**
+ * Mangled names contain the IR id of the function and of the types it uses
+ * as a disambiguator. Those ids change every time unrelated code is added
+ * before them, which would make profiles stop matching after a rebuild.
+ * Profiles are keyed by function name, so for profile guided builds the ids
+ * are replaced by a counter that only disambiguates functions which would
+ * otherwise get the same name.
+ */
+void stabilizeFunctionNames(llvm::Module* module) {
+  std::map<std::string, unsigned> seen;
+  for (auto& f : *module) {
+    if (f.isDeclaration() || !f.getName().startswith(_SN_MANGLE_PREFIX)) continue;
+    auto name = stripDisambiguators(f.getName());
+    auto count = seen[name]++;
+    f.setName(count == 0 ? name : name + "." + std::to_string(count));
+  }
+}
+/**
+ * Async functions are emitted as "pre-split" coroutines, they must be split
+ * into their ramp, resume and destroy functions before code generation. The
+ * default pipelines do it for O1 and above but -O0 builds skip them, and
+ * anything that slipped through the pipeline (e.g. a coroutine only reached
+ * after inlining) is split here too.
+ */
+void lowerCoroutines(llvm::Module* module) {
+  bool hasCoroutines = false;
+  for (auto& f : *module) {
+    if (f.isPresplitCoroutine()) {
+      hasCoroutines = true;
+      break;
+    }
+  }
+  if (!hasCoroutines) return;
+  llvm::LoopAnalysisManager lam;
+  llvm::FunctionAnalysisManager fam;
+  llvm::CGSCCAnalysisManager cgam;
+  llvm::ModuleAnalysisManager mam;
+  llvm::PassBuilder pb;
+  pb.registerModuleAnalyses(mam);
+  pb.registerCGSCCAnalyses(cgam);
+  pb.registerFunctionAnalyses(fam);
+  pb.registerLoopAnalyses(lam);
+  pb.crossRegisterProxies(lam, fam, cgam, mam);
+  llvm::ModulePassManager mpm;
+  mpm.addPass(llvm::CoroEarlyPass());
+  mpm.addPass(llvm::createModuleToPostOrderCGSCCPassAdaptor(llvm::CoroSplitPass()));
+  mpm.addPass(llvm::CoroCleanupPass());
+  mpm.run(*module, mam);
 }
 } // namespace
 
@@ -65,15 +148,47 @@ void applyDebugTransformations(llvm::Module* module, bool debug) {
 namespace codegen {
 
 void LLVMBuilder::optimizeModule() {
+  bool keepDebugInfo = dbg.kind != llvm::DICompileUnit::NoDebug;
+  std::optional<llvm::PGOOptions> pgo;
+  if (sizeOptions.report) recordSizesBeforeOptimization();
+  if (profileOptions.generate) {
+    pgo = llvm::PGOOptions(profileOptions.generateFile, "", "", llvm::PGOOptions::IRInstr);
+  } else if (!profileOptions.use.empty()) {
+    pgo = llvm::PGOOptions(profileOptions.use, "", "", llvm::PGOOptions::IRUse);
+  }
+  if (pgo) stabilizeFunctionNames(module.get());
+  if (ctx->optimizationLevel == app::Options::Optimization::OPTIMIZE_O0 && !pgo) {
+    // Debug builds skip the optimization pipeline entirely. The only pass
+    // the -O0 pipeline would run that matters is the always-inliner.
+    llvm::legacy::PassManager pm;
+    pm.add(llvm::createAlwaysInlinerLegacyPass());
+    if (dbg.verify) pm.add(llvm::createVerifierPass());
+    pm.run(*module);
+    lowerCoroutines(module.get());
+    if (sizeOptions.icf) foldIdenticalFunctions();
+    if (sizeOptions.report) recordSizesAfterOptimization();
+    applyDebugTransformations(module.get(), dbg.debug, keepDebugInfo);
+    return;
+  }
   llvm::LoopAnalysisManager loop_analysis_manager;
   llvm::FunctionAnalysisManager function_analysis_manager;
   llvm::CGSCCAnalysisManager c_gscc_analysis_manager;
   llvm::ModuleAnalysisManager module_analysis_manager;
+  // Let every function know the CPU and features it's compiled for, so
+  // the cost models (and the inliner's compatibility checks) match the
+  // real target.
+  auto targetCPU = target->getTargetCPU();
+  auto targetFeatures = target->getTargetFeatureString();
+  for (auto& f : *module) {
+    if (f.isDeclaration()) continue;
+    if (!targetCPU.empty()) f.addFnAttr("target-cpu", targetCPU);
+    if (!targetFeatures.empty()) f.addFnAttr("target-features", targetFeatures);
+  }
   // Create the new pass manager builder.
   // Take a look at the PassBuilder constructor parameters for more
   // customization, e.g. specifying a TargetMachine or various
   // debugging options.
-  llvm::PassBuilder pass_builder;
+  llvm::PassBuilder pass_builder(target, llvm::PipelineTuningOptions(), pgo);
   // Register all the basic analyses with the managers.
   pass_builder.registerModuleAnalyses(module_analysis_manager);
   pass_builder.registerCGSCCAnalyses(c_gscc_analysis_manager);
@@ -98,16 +213,26 @@ void LLVMBuilder::optimizeModule() {
   }
   std::vector<std::function<void(llvm::ModulePassManager&, llvm::OptimizationLevel)>> PipelineStartEPCallbacks;
   std::vector<std::function<void(llvm::ModulePassManager&, llvm::OptimizationLevel)>> OptimizerLastEPCallbacks;
-  PipelineStartEPCallbacks.push_back([](llvm::ModulePassManager & MPM, llvm::OptimizationLevel Level) {
-                                       MPM.addPass(llvm::VerifierPass());
+  if (dbg.verify) {
+    PipelineStartEPCallbacks.push_back([](llvm::ModulePassManager & MPM, llvm::OptimizationLevel Level) {
+                                         MPM.addPass(llvm::VerifierPass());
+                                       });
+  }
+  // Move cold code (e.g. the code building an exception before throwing it)
+  // out of the hot functions.
+  // note: the outlined functions and their call stubs make the code bigger,
+  //  so it's skipped when optimizing for size (like clang does).
+  OptimizerLastEPCallbacks.push_back([](llvm::ModulePassManager & MPM, llvm::OptimizationLevel Level) {
+                                       if (Level.getSpeedupLevel() > 0 && Level.getSizeLevel() == 0)
+                                         MPM.addPass(llvm::HotColdSplittingPass());
                                      });
   for (const auto& C : PipelineStartEPCallbacks) pass_builder.registerPipelineStartEPCallback(C);
   for (const auto& C : OptimizerLastEPCallbacks) pass_builder.registerOptimizerLastEPCallback(C);
   llvm::ModulePassManager mpm;
-  if (dbg.debug) {
-    mpm = pass_builder.buildThinLTODefaultPipeline(level, nullptr);
-  } else {
 #if PERFORM_SIMPLE_OPTS
+  // note: -O0 only gets here with a profile, it only runs the
+  //  instrumentation (or profile use) passes of the O0 pipeline.
+  if (level != llvm::OptimizationLevel::O0) {
     {
       // simple optimizations done for each function. It does not depend on the optimization level.
       std::unique_ptr<llvm::legacy::FunctionPassManager> functionPassManager =
@@ -131,11 +256,14 @@ void LLVMBuilder::optimizeModule() {
     llvm::legacy::PassManager codegen_pm;
     codegen_pm.add(llvm::createTargetTransformInfoWrapperPass(target->getTargetIRAnalysis()));
     codegen_pm.run(*module);
-#endif
-    mpm = pass_builder.buildLTOPreLinkDefaultPipeline(level);
   }
+#endif
+  mpm = pass_builder.buildLTOPreLinkDefaultPipeline(level);
   mpm.run(*module, module_analysis_manager);
-  applyDebugTransformations(module.get(), dbg.debug);
+  lowerCoroutines(module.get());
+  if (sizeOptions.icf) foldIdenticalFunctions();
+  if (sizeOptions.report) recordSizesAfterOptimization();
+  applyDebugTransformations(module.get(), dbg.debug, keepDebugInfo);
 }
 
 } // namespace codegen
@@ -0,0 +1,79 @@
+#include "../../../errors.h"
+#include "../../../utils/utils.h"
+#include "../LLVMBuilder.h"
+
+#include <llvm/IR/Function.h>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Object/SymbolSize.h>
+
+#include <fstream>
+
+namespace snowball {
+namespace codegen {
+
+void LLVMBuilder::recordSizesBeforeOptimization() {
+  sizeReport.functions.clear();
+  reportedFunctions.clear();
+  for (auto& f : *module) {
+    if (f.isDeclaration()) continue;
+    auto snModule = functionModules.find(&f);
+    SizeReport::Function entry;
+    entry.name = f.getName().str();
+    entry.module = snModule == functionModules.end() ? iModule->getName() : snModule->second;
+    entry.irBefore = f.getInstructionCount();
+    sizeReport.functions.push_back(entry);
+    reportedFunctions.push_back({&f, llvm::WeakTrackingVH(&f)});
+  }
+}
+
+void LLVMBuilder::recordSizesAfterOptimization() {
+  for (size_t i = 0; i < reportedFunctions.size(); i++) {
+    auto& [original, handle] = reportedFunctions[i];
+    // Functions that were inlined, removed or folded into another one keep
+    // their original name and have no instructions left.
+    auto kept = llvm::dyn_cast_or_null<llvm::Function>(handle);
+    if (kept != original) continue;
+    sizeReport.functions[i].name = kept->getName().str();
+    sizeReport.functions[i].irAfter = kept->getInstructionCount();
+  }
+}
+
+std::map<std::string, uint64_t> LLVMBuilder::getSymbolSizes(const std::string& object) {
+  std::map<std::string, uint64_t> sizes;
+  auto binary = llvm::object::ObjectFile::createObjectFile(object);
+  if (!binary) {
+    llvm::consumeError(binary.takeError());
+    return sizes;
+  }
+  for (auto [symbol, size] : llvm::object::computeSymbolSizes(*binary->getBinary())) {
+    auto name = symbol.getName();
+    if (!name) {
+      llvm::consumeError(name.takeError());
+      continue;
+    }
+    // Darwin prefixes every symbol with an underscore
+    auto symbolName = name->str();
+    if (target->getTargetTriple().isOSDarwin() && utils::startsWith(symbolName, "_")) symbolName = symbolName.substr(1);
+    sizes[symbolName] = size;
+  }
+  return sizes;
+}
+
+void LLVMBuilder::reportSize(const std::string& object) {
+  auto sizes = getSymbolSizes(object);
+  for (auto& function : sizeReport.functions) {
+    auto size = sizes.find(function.name);
+    function.bytes = size == sizes.end() ? 0 : size->second;
+  }
+  if (sizeOptions.reportFile.empty()) {
+    sizeReport.print(sizeOptions.reportSort);
+    return;
+  }
+  std::ofstream out(sizeOptions.reportFile);
+  if (!out) throw SNError(Error::IO_ERROR, FMT("Could not open file: %s", sizeOptions.reportFile.c_str()));
+  out << sizeReport.toJSON().dump(2) << std::endl;
+  Logger::message("Size report", FMT("written to %s", sizeOptions.reportFile.c_str()));
+}
+
+} // namespace codegen
+} // namespace snowball
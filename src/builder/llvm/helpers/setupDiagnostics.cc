@@ -0,0 +1,115 @@
+#include "../../../errors.h"
+#include "../../../SourceInfo.h"
+#include "../../../utils/utils.h"
+#include "../LLVMBuilder.h"
+
+#include <llvm/IR/DiagnosticHandler.h>
+#include <llvm/IR/DiagnosticInfo.h>
+#include <llvm/IR/LLVMRemarkStreamer.h>
+#include <llvm/Support/Regex.h>
+
+#include <filesystem>
+#include <map>
+#include <sstream>
+
+namespace snowball {
+namespace codegen {
+
+namespace {
+/// @return The text of the line number `line` (starting at 1) of a source file
+std::string getLine(const SourceInfo* source, unsigned line) {
+  // note: not a `DBGSourceInfo`, those can't be destroyed and one would
+  //  be leaked for every remark.
+  std::istringstream stream(source->getSource());
+  std::string text;
+  for (unsigned i = 0; i < line && std::getline(stream, text); i++) { }
+  return text;
+}
+/**
+ * @brief Diagnostic handler used for every module generated by the compiler.
+ *
+ * It reports the optimizations that could not be applied even though the user
+ * asked for them (e.g. `@unroll(4)` on a loop that can't be unrolled) and the
+ * optimization remarks requested with `--remarks`.
+ */
+class SnowballDiagnosticHandler : public llvm::DiagnosticHandler {
+  // Passes to report remarks for, remarks are disabled if it's not set
+  std::optional<llvm::Regex> filter;
+  // Source files of the project, indexed by their normalized path
+  std::map<std::string, const SourceInfo*> sources;
+
+ public:
+  SnowballDiagnosticHandler(std::shared_ptr<ir::MainModule> mainModule, const std::string& remarks) {
+    if (!remarks.empty()) filter.emplace(remarks);
+    sources[mainModule->getSourceInfo()->getPath()] = mainModule->getSourceInfo();
+    for (auto& module : mainModule->getModules()) { sources[module->getSourceInfo()->getPath()] = module->getSourceInfo(); }
+  }
+
+  bool isAnalysisRemarkEnabled(llvm::StringRef pass) const override { return filter && filter->match(pass); }
+  bool isMissedOptRemarkEnabled(llvm::StringRef pass) const override { return filter && filter->match(pass); }
+  bool isPassedOptRemarkEnabled(llvm::StringRef pass) const override { return filter && filter->match(pass); }
+  bool isAnyRemarkEnabled() const override { return filter.has_value(); }
+
+  bool handleDiagnostics(const llvm::DiagnosticInfo& info) override {
+    if (auto failure = llvm::dyn_cast<llvm::DiagnosticInfoOptimizationFailure>(&info)) {
+      std::string location = failure->isLocationAvailable() ? failure->getLocationStr() + ": " : "";
+      Logger::warning(location + failure->getMsg());
+      return true;
+    } else if (auto remark = llvm::dyn_cast<llvm::DiagnosticInfoOptimizationBase>(&info)) {
+      // note: the context only gets here for the remarks enabled by the filter
+      printRemark(*remark);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  /// @brief Print a remark next to the snowball code it refers to (if it's available)
+  void printRemark(const llvm::DiagnosticInfoOptimizationBase& remark) {
+    auto color = remark.isPassed() ? BGRN : (remark.isMissed() ? BYEL : BCYN);
+    auto kind = remark.isPassed() ? "passed" : (remark.isMissed() ? "missed" : "analysis");
+    Logger::elog(FMT("%s[remark:%s]%s %s%s%s: %s", color, kind, RESET, BOLD, remark.getPassName().str().c_str(), RESET,
+                     remark.getMsg().c_str()));
+    if (!remark.isLocationAvailable()) return;
+    auto location = remark.getLocation();
+    auto path = std::filesystem::path(location.getAbsolutePath()).lexically_normal().string();
+    Logger::elog(FMT("%s       ├─[%s%s%s%s:%i:%i%s%s]%s", BLK, RESET, BBLU, path.c_str(), BBLK, location.getLine(),
+                     location.getColumn(), RESET, BLK, RESET));
+    auto source = sources.find(path);
+    if (source == sources.end() || location.getLine() == 0) return;
+    auto line = getLine(source->second, location.getLine());
+    Logger::elog(FMT(" %s %4i%s >%s  %s%s", BWHT, location.getLine(), BLK, RESET, line.c_str(), RESET));
+  }
+};
+} // namespace
+
+std::unique_ptr<llvm::DiagnosticHandler> LLVMBuilder::createDiagnosticHandler() {
+  auto mainModule = utils::dyn_cast<ir::MainModule>(iModule);
+  assert(mainModule);
+  return std::make_unique<SnowballDiagnosticHandler>(mainModule, remarkOptions.filter);
+}
+
+void LLVMBuilder::setupDiagnostics() {
+  if (!remarkOptions.filter.empty()) {
+    std::string error;
+    if (!llvm::Regex(remarkOptions.filter).isValid(error)) {
+      throw SNError(Error::ARGUMENT_ERROR, FMT("Invalid remarks filter '%s': %s", remarkOptions.filter.c_str(), error.c_str()));
+    }
+  }
+  context->setDiagnosticHandler(createDiagnosticHandler());
+  if (remarkOptions.output.empty()) return;
+  // Remarks are weighted by how hot the code is when a profile is available
+  context->setDiagnosticsHotnessRequested(!profileOptions.use.empty());
+  auto file = llvm::setupLLVMOptimizationRemarks(
+    *context, remarkOptions.output, remarkOptions.filter, remarkOptions.format,
+    /*RemarksWithHotness=*/!profileOptions.use.empty()
+  );
+  if (auto error = file.takeError()) {
+    throw SNError(Error::IO_ERROR, FMT("Could not set up the remarks file: %s", llvm::toString(std::move(error)).c_str()));
+  }
+  remarksFile = std::move(*file);
+  remarksFile->keep();
+}
+
+} // namespace codegen
+} // namespace snowball
@@ -121,7 +121,6 @@ llvm::FunctionType* LLVMBuilder::getLLVMFunctionType(types::FunctionType* fn, co
 }
 
 llvm::Type* LLVMBuilder::createEnumFieldType(types::EnumType* ty, std::string field) {
-  static std::unordered_map<std::string, llvm::Type*> enumTypes;
   auto name = _SN_ENUM_PREFIX + ty->getMangledName() + "__" + field;
   if (enumTypes.find(name) != enumTypes.end()) return enumTypes.find(name)->second;
   auto enumField = *std::find_if(ty->getFields().begin(), ty->getFields().end(), [&](auto f) {
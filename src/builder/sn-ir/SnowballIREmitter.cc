@@ -38,6 +38,7 @@ void SnowballIREmitter::visit(std::shared_ptr<ir::Module> m) {
       addContent("  external ");
     else
       addContent("  ");
+    if (f->isCoroutine()) addContent("async ");
     addContent("func " + f->getNiceName() + "(");
     for (auto p : f->getArgs()) {
       p.second->visit(this);
@@ -149,6 +150,12 @@ void SnowballIREmitter::visit(ir::Cast* c) {
   addContent(")");
 }
 
+void SnowballIREmitter::visit(ir::Await* a) {
+  addContent("await(");
+  a->getFuture()->visit(this);
+  addContent(")");
+}
+
 void SnowballIREmitter::visit(ir::TryCatch* tc) {
   addContent("try ");
   tc->getBlock()->visit(this);
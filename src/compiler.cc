@@ -15,19 +15,21 @@
 #include "visitors/analyzers/DefinitveAssigment.h"
 #include "visitors/documentation/DocGen.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <regex>
 #include <stdio.h>
 #include <string>
+#include <tuple>
 #include <unistd.h>
 
 namespace fs = std::filesystem;
 
 namespace snowball {
-Compiler::Compiler(std::string p_code, std::string p_path) {
+Compiler::Compiler(std::string p_code, std::string p_path, fs::path p_cwd) {
   source = p_code;
-  cwd = fs::current_path();
+  cwd = p_cwd;
   path = path / p_path;
   srcInfo = nullptr;
 }
@@ -53,34 +55,48 @@ void Compiler::compile(bool silent) {
 #else
 #define SHOW_STATUS(_)
 #endif
+  ir::IdGenerator::Scope idScope(idGenerator);
+  sourceFiles = {cwd / path};
   runPackageManager(silent);
   SHOW_STATUS(Logger::compiling(Logger::progress(0)));
   /* ignore_goto_errors() */ {
     SHOW_STATUS(Logger::compiling(Logger::progress(0.30)))
-    auto lexer = new Lexer(srcInfo);
+    auto mainPath = (cwd / path).lexically_normal();
+    auto cached = parseCache ? parseCache->get(mainPath, source) : std::nullopt;
+    parser::Parser::NodeVec ast;
+    bool parsed = cached.has_value();
+    if (cached) {
+      // note: the nodes point to the source info they were parsed with
+      srcInfo = cached->srcInfo;
+      ast = cached->ast;
+    } else {
+      Lexer lexer(srcInfo);
 #if _SNOWBALL_TIMERS_DEBUG
-    DEBUG_TIMER("Lexer: %fs", utils::_timer([&] { lexer->tokenize(); }));
+      DEBUG_TIMER("Lexer: %fs", utils::_timer([&] { lexer.tokenize(); }));
 #else
-    lexer->tokenize();
+      lexer.tokenize();
 #endif
-    auto tokens = lexer->tokens;
-    if (tokens.size() != 0) {
-      SHOW_STATUS(Logger::compiling(Logger::progress(0.40)))
-      parser::Parser parser(tokens, srcInfo);
+      auto tokens = lexer.tokens;
+      if (tokens.size() != 0) {
+        SHOW_STATUS(Logger::compiling(Logger::progress(0.40)))
+        parser::Parser parser(tokens, srcInfo);
 #if _SNOWBALL_TIMERS_DEBUG
-      parser::Parser::NodeVec ast;
-      DEBUG_TIMER("Parser: %fs", utils::_timer([&] { ast = parser.parse(); }));
+        DEBUG_TIMER("Parser: %fs", utils::_timer([&] { ast = parser.parse(); }));
 #else
-      auto ast = parser.parse();
+        ast = parser.parse();
 #endif
+        parsed = true;
+        if (parseCache) parseCache->set(mainPath, srcInfo, ast);
+      }
+    }
+    if (parsed) {
       SHOW_STATUS(Logger::compiling(Logger::progress(0.50)))
       auto mainModule = std::make_shared<ir::MainModule>();
       mainModule->setSourceInfo(srcInfo);
-      auto simplifier = new Syntax::Transformer(
-        mainModule->downcasted_shared_from_this<ir::Module>(), srcInfo, ((fs::path) path).parent_path(), testsEnabled,
-        benchmarkEnabled, silent
+      auto simplifier = std::make_unique<Syntax::Transformer>(
+        mainModule->downcasted_shared_from_this<ir::Module>(), srcInfo, (cwd / path).parent_path(), cwd, testsEnabled,
+        benchmarkEnabled, silent, parseCache
       );
-      chdir(((fs::path) path).parent_path().c_str());
 #if _SNOWBALL_TIMERS_DEBUG
       DEBUG_TIMER("Simplifier: %fs", utils::_timer([&] { simplifier->visitGlobal(ast); }));
 #else
@@ -88,6 +104,24 @@ void Compiler::compile(bool silent) {
 #endif
       SHOW_STATUS(Logger::compiling(Logger::progress(0.70)))
       mainModule->setModules(simplifier->getModules());
+      for (auto& m : mainModule->getModules()) {
+        // The runtime only spawns threads on behalf of these modules
+        if (m->getName() == "std::thread" || m->getName() == "std::task") globalContext.isThreaded = true;
+      }
+      auto imported = simplifier->getImportedPaths();
+      sourceFiles.insert(sourceFiles.end(), imported.begin(), imported.end());
+      dependencies.clear();
+      for (auto& [file, imports] : simplifier->getImportDependencies()) {
+        // The main file is the only one that may be relative to the project
+        dependencies[(cwd / file).lexically_normal()].insert(imports.begin(), imports.end());
+      }
+      if (globalContext.size.report) {
+        instantiations.clear();
+        auto cache = simplifier->getCache();
+        for (auto& [name, count] : cache->Types::getInstantiations()) instantiations.push_back({name, "type", count});
+        for (auto& [name, count] : cache->Functions::getInstantiations())
+          instantiations.push_back({name, "function", count});
+      }
       module = mainModule;
 #if _SNOWBALL_TIMERS_DEBUG
       DEBUG_TIMER("Passes: %fs", utils::_timer([&] {
@@ -110,7 +144,6 @@ void Compiler::compile(bool silent) {
       SHOW_STATUS(Logger::compiling(Logger::progress(1)))
       SHOW_STATUS(Logger::reset_status())
     }
-    chdir(cwd.c_str());
   }
 }
 
@@ -118,9 +151,9 @@ using recursive_directory_iterator = std::filesystem::recursive_directory_iterat
 
 void Compiler::runPackageManager(bool silent) {
   if (!globalContext.packageManagerEnabled) return;
-  auto package = getConfiguration();
-  auto manager = new pm::Manager(package, silent, cwd, configFolder);
-  manager->runAsMain();
+  auto package = getConfiguration(cwd);
+  pm::Manager manager(package, silent, cwd, configFolder);
+  manager.runAsMain();
 }
 
 int Compiler::emitDocs(std::string folder, std::string baseURL, BasicPackageInfo package, bool silent) {
@@ -208,8 +241,8 @@ int Compiler::emitDocs(std::string folder, std::string baseURL, BasicPackageInfo
 }
 #undef SHOW_STATUS
 
-toml::parse_result Compiler::getConfiguration() {
-  std::string name = fs::current_path() / "sn.toml";
+toml::parse_result Compiler::getConfiguration(fs::path root) {
+  std::string name = root / "sn.toml";
   std::ifstream f(name.c_str());
   if (f.good()) { return toml::parse_file(name); }
   throw SNError(
@@ -228,56 +261,111 @@ void Compiler::enamblePackageManager(bool enable) {
 
 void Compiler::cleanup() { }
 
-int Compiler::emitObject(std::string out, bool log) {
-  auto builder = new codegen::LLVMBuilder(module, opt_level, testsEnabled, benchmarkEnabled);
-  builder->codegen();
-  builder->optimizeModule();
-#if _SNOWBALL_BYTECODE_DEBUG
-  builder->dump();
-#endif
-  return builder->emitObjectFile(out, log);
-}
-
-int Compiler::emitLLVMIr(std::string p_output, bool p_pmessage) {
-  auto builder = new codegen::LLVMBuilder(module, opt_level, testsEnabled, benchmarkEnabled);
-  builder->codegen();
-  builder->optimizeModule();
-  std::error_code EC;
-  llvm::raw_fd_ostream dest(p_output, EC);
-  if (EC) throw SNError(Error::IO_ERROR, Logger::format("Could not open file: %s", EC.message().c_str()));
-  builder->print(dest);
-  if (p_pmessage) Logger::success("Snowball project transpiled to llvm IR code! 🎉\n");
-  return EXIT_SUCCESS;
-}
-
-int Compiler::emitASM(std::string p_output, bool p_pmessage) {
-  auto builder = new codegen::LLVMBuilder(module, opt_level, testsEnabled, benchmarkEnabled);
-  builder->codegen();
-  builder->optimizeModule();
-  auto res = builder->emitObjectFile(p_output, false, false);
-  if (p_pmessage) Logger::success("Snowball project transpiled to assembly code! 🎉\n");
-  return res;
+std::unique_ptr<codegen::LLVMBuilder> Compiler::createBuilder() {
+  auto builder = std::make_unique<codegen::LLVMBuilder>(
+    module, opt_level, testsEnabled, benchmarkEnabled, globalContext.target, globalContext.profile,
+    globalContext.debug, globalContext.remarks, globalContext.size
+  );
+  builder->getSizeReport().templates = instantiations;
+  return builder;
 }
 
-int Compiler::emitBinary(std::string out, bool log) {
+int Compiler::linkBinary(std::string objfile, std::string out, bool log, bool removeObject) {
   std::vector<std::string> extraLinkerArgs = {};
-  auto objfile = linker::Linker::getSharedLibraryName(out);
-  DEBUG_CODEGEN("Emitting object file... (%s)", objfile.c_str());
-  int objstatus = emitObject(objfile, false);
-  if (objstatus != EXIT_SUCCESS) return objstatus;
+  if (globalContext.profile.generate) {
+    if (std::string(_SNOWBALL_PROFILE_RT).empty())
+      throw SNError(Error::LINKER_ERR, "Could not find the LLVM profile runtime needed by '--profile-generate'!");
+    extraLinkerArgs.push_back(_SNOWBALL_PROFILE_RT);
+  }
   auto linker = linker::Linker(globalContext, LD_PATH);
   for (auto lib : linkedLibraries) { linker.addLibrary(lib); }
   // TODO: add user-defined extra ld args
   linker.link(objfile, out, extraLinkerArgs);
   if (log) Logger::success(Logger::format("Snowball project successfully compiled! 🥳", BGRN, RESET, out.c_str()));
   // clean up
-  DEBUG_CODEGEN("Cleaning up object file... (%s)", objfile.c_str());
-  remove(objfile.c_str());
+  if (removeObject) {
+    DEBUG_CODEGEN("Cleaning up object file... (%s)", objfile.c_str());
+    remove(objfile.c_str());
+  }
+  return EXIT_SUCCESS;
+}
+
+int Compiler::emit(std::vector<std::pair<app::Options::EmitType, std::string>> outputs, bool log) {
+  using EmitType = app::Options::EmitType;
+  ir::IdGenerator::Scope idScope(idGenerator);
+  upToDate = false;
+  std::unique_ptr<codegen::LLVMBuilder> builder = nullptr;
+  // Object and assembly files are emitted together at the end
+  std::vector<std::pair<std::string, bool>> objects;
+  // Object files that need to be linked into an executable (and if they are temporary)
+  std::vector<std::tuple<std::string, std::string, bool>> binaries;
+  for (auto& [type, out] : outputs) {
+    if (type == EmitType::SNOWBALL_IR) {
+      emitSnowballIr(out, false);
+      continue;
+    }
+    if (!builder) {
+      builder = createBuilder();
+      builder->codegen();
+      if (hashModule) {
+        std::string text;
+        llvm::raw_string_ostream stream(text);
+        builder->print(stream);
+        moduleHash = std::hash<std::string> {}(stream.str());
+        upToDate = unchangedModuleHash == moduleHash &&
+                   std::all_of(outputs.begin(), outputs.end(), [](auto& o) { return fs::exists(o.second); });
+        if (upToDate) return EXIT_SUCCESS;
+      }
+      builder->optimizeModule();
+#if _SNOWBALL_BYTECODE_DEBUG
+      builder->dump();
+#endif
+    }
+    switch (type) {
+      case EmitType::LLVM_IR: {
+        std::error_code EC;
+        llvm::raw_fd_ostream dest(out, EC);
+        if (EC) throw SNError(Error::IO_ERROR, Logger::format("Could not open file: %s", EC.message().c_str()));
+        builder->print(dest);
+        break;
+      }
+      case EmitType::LLVM_BC: builder->emitBitcode(out); break;
+      case EmitType::ASSEMBLY: objects.push_back({out, false}); break;
+      case EmitType::OBJECT: objects.push_back({out, true}); break;
+      case EmitType::EXECUTABLE: {
+        // Link the object file that was also requested (if any) instead of
+        // writing the same code twice. Otherwise it goes to a temporary file
+        // that doesn't clash with any other output.
+        auto requested = std::find_if(outputs.begin(), outputs.end(), [](auto& o) {
+          return o.first == EmitType::OBJECT;
+        });
+        if (requested != outputs.end()) {
+          binaries.push_back({requested->second, out, false});
+          break;
+        }
+        auto name = FMT("%s.%d.%zu.o", fs::path(out).filename().c_str(), (int)getpid(), binaries.size());
+        auto objfile = (configFolder / "bin" / name).string();
+        objects.push_back({objfile, true});
+        binaries.push_back({objfile, out, true});
+        break;
+      }
+      default: assert(false && "unhandled emit type");
+    }
+  }
+  if (!objects.empty()) builder->emitObjectFiles(objects);
+  for (auto& [objfile, out, temporary] : binaries) {
+    int status = linkBinary(objfile, out, false, temporary);
+    if (status != EXIT_SUCCESS) return status;
+  }
+  if (log) {
+    for (auto& [_, out] : outputs) Logger::success(FMT("Generated %s%s%s", BOLD, out.c_str(), RESET));
+  }
   return EXIT_SUCCESS;
 }
 
 int Compiler::emitSnowballIr(std::string p_output, bool p_pmessage) {
-  auto builder = new codegen::SnowballIREmitter(module);
+  ir::IdGenerator::Scope idScope(idGenerator);
+  auto builder = std::make_unique<codegen::SnowballIREmitter>(module);
   builder->codegen(p_output);
   if (p_pmessage) Logger::success("Snowball project transpiled to snowball IR code! 🎉\n");
   return EXIT_SUCCESS;
@@ -1,14 +1,20 @@
 
 #include "../app/cli.h"
 #include "SourceInfo.h"
+#include "builder/llvm/SizeReport.h"
 #include "common.h"
+#include "ir/id.h"
 #include "ir/module/MainModule.h"
 #include "ir/module/Module.h"
 #include "lexer/lexer.h"
+#include "services/ParseCache.h"
 #include "vendor/toml.hpp"
 #include "./visitors/documentation/DocGen.h"
 
 #include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
 #include <string>
 
 namespace fs = std::filesystem;
@@ -25,6 +31,9 @@ namespace fs = std::filesystem;
     pass->run(ast);
 
 namespace snowball {
+namespace codegen {
+class LLVMBuilder;
+}
 
 /**
  * @brief Global context for the compiler
@@ -43,6 +52,11 @@ struct GlobalContext {
 
   bool isDynamic = true;
   app::Options::Optimization opt = app::Options::Optimization::OPTIMIZE_O0;
+  app::Options::TargetOptions target;
+  app::Options::ProfileOptions profile;
+  app::Options::DebugOptions debug;
+  app::Options::RemarkOptions remarks;
+  app::Options::SizeOptions size;
 };
 
 /**
@@ -52,13 +66,22 @@ struct GlobalContext {
  * Main class that handles all the compiling process of snowball. Note that it does not
  * actually compile, the llvm builder does the actual compilation. This class is more of
  * a wrapper around the whole compiler functionality.
+ *
+ * A compiler instance acts as a compilation session: all of its state (project root,
+ * IR ids, import caches, modules) is owned by the instance and the process working
+ * directory is never changed. This means that multiple instances can be created in the
+ * same process and compiled at the same time from different threads.
  */
 class Compiler {
   // variables
   std::string source;
   fs::path path;
 
+  // Project root. Everything is resolved against it instead of the
+  // process working directory.
   fs::path cwd;
+  // Id generator used for every IR node created by this session.
+  ir::IdGenerator idGenerator;
   app::Options::Optimization opt_level;
 
   GlobalContext globalContext;
@@ -69,21 +92,41 @@ class Compiler {
   bool benchmarkEnabled = false;
 
   std::shared_ptr<ir::MainModule> module;
+  // Every source file that took part in the last compilation.
+  std::vector<fs::path> sourceFiles;
+  // Files imported directly by each source file of the last compilation.
+  std::map<fs::path, std::set<fs::path>> dependencies;
+  // Parsed files shared with other sessions (see `setParseCache`).
+  std::shared_ptr<services::ParseCache> parseCache = nullptr;
+  // Hash of the LLVM module generated by the last `emit`, before optimizing it.
+  std::size_t moduleHash = 0;
+  // `emit` stops after generating the module if it hashes to this value.
+  std::optional<std::size_t> unchangedModuleHash = std::nullopt;
+  bool hashModule = false;
+  bool upToDate = false;
+  // Generic instantiations done by the last compilation (for `--size-report`)
+  std::vector<codegen::SizeReport::Template> instantiations;
 
  public:
-  Compiler(std::string p_code, std::string p_path);
+  Compiler(std::string p_code, std::string p_path, fs::path p_cwd = fs::current_path());
 
   void initialize();
   void compile(bool verbose = true);
+  /**
+   * @brief Run only the front end of the compiler (lexer, parser, transformer,
+   *  passes and type checker) and report any diagnostics as exceptions.
+   * @note LLVM is never initialized by this method, no module gets generated.
+   */
+  void check(bool silent = true) { compile(silent); }
 
   void cleanup();
 
-  static toml::parse_result getConfiguration();
+  static toml::parse_result getConfiguration(fs::path root = fs::current_path());
   void enable_tests() { testsEnabled = true; }
   void enable_benchmark() { benchmarkEnabled = true; }
 
   // Get
-  ~Compiler() {};
+  ~Compiler() noexcept = default;
 
   std::vector<std::string> linkedLibraries;
   fs::path configFolder;
@@ -93,26 +136,89 @@ class Compiler {
     std::string version;
   };
 
-  int emitBinary(std::string, bool = true);
-  int emitObject(std::string, bool = true);
-  int emitLLVMIr(std::string, bool = true);
-  int emitASM(std::string, bool = true);
   int emitSnowballIr(std::string, bool = true);
   int emitDocs(std::string, std::string, BasicPackageInfo, bool = true);
+  /**
+   * @brief Emit the project in multiple formats at once.
+   *
+   * The LLVM module is generated and optimized only once and every requested
+   * output (IR, bitcode, assembly, objects and executables) is written from it.
+   * Object and assembly files are generated in parallel.
+   */
+  int emit(std::vector<std::pair<app::Options::EmitType, std::string>> outputs, bool = true);
 
   void enamblePackageManager(bool);
 
   GlobalContext& getGlobalContext() { return globalContext; }
+  /// @return The main file and every file imported by the last compilation
+  const std::vector<fs::path>& getSourceFiles() const { return sourceFiles; }
+  /// @return The files imported directly by each source file of the last compilation
+  const std::map<fs::path, std::set<fs::path>>& getDependencies() const { return dependencies; }
+  /**
+   * @brief Reuse the files parsed by other sessions of the same project.
+   *
+   * Files are only parsed again if their contents are different from the
+   * ones in the cache, and the newly parsed ones are added to it.
+   */
+  void setParseCache(std::shared_ptr<services::ParseCache> c) { parseCache = c; }
+  /**
+   * @brief Hash the LLVM module generated by `emit`, and don't optimize, write or
+   *  link anything if it hashes to `hash` (and every output already exists).
+   * @note It's meant to be given `getModuleHash` from the previous build.
+   */
+  void skipEmitIfUnchanged(std::optional<std::size_t> hash) {
+    hashModule = true;
+    unchangedModuleHash = hash;
+  }
+  /// @return The hash of the LLVM module generated by the last `emit`
+  std::size_t getModuleHash() const { return moduleHash; }
+  /// @return If the last `emit` was skipped because the outputs were up to date
+  bool isUpToDate() const { return upToDate; }
 
   void setOptimization(app::Options::Optimization o) {
     globalContext.opt = o;
     opt_level = o;
   }
+  /// @brief Set the CPU and features to generate code for.
+  void setTarget(app::Options::TargetOptions t) { globalContext.target = t; }
+  /// @brief Set the debug information level and IR verification.
+  void setDebug(app::Options::DebugOptions d) { globalContext.debug = d; }
+  /// @brief Set the options used to reduce (and report) the code size.
+  void setSizeOptions(app::Options::SizeOptions s) {
+    if (s.reportSort != "size" && s.reportSort != "ir" && s.reportSort != "name")
+      throw SNError(Error::ARGUMENT_ERROR, FMT("Invalid size report sort '%s' (expected size, ir or name)", s.reportSort.c_str()));
+    globalContext.size = s;
+  }
+  /// @brief Set the optimization remarks to report.
+  void setRemarks(app::Options::RemarkOptions r) {
+    if (!r.output.empty() && r.filter.empty()) r.filter = ".*";
+    globalContext.remarks = r;
+  }
+  /// @brief Set the profile guided optimization mode.
+  void setProfile(app::Options::ProfileOptions p) {
+    if (p.generate && !p.use.empty())
+      throw SNError(Error::ARGUMENT_ERROR, "'--profile-generate' and '--profile-use' can't be used together!");
+    if (!p.use.empty() && !fs::exists(p.use))
+      throw SNError(Error::IO_ERROR, FMT("Profile data file not found (%s)", p.use.c_str()));
+    globalContext.profile = p;
+  }
+  /**
+   * @brief Fill the target options that haven't been given through the command
+   *  line with the ones from the `[build]` section of the project configuration.
+   */
+  static app::Options::TargetOptions getTargetOptions(toml::parse_result& config, app::Options::TargetOptions t) {
+    if (t.cpu.empty()) t.cpu = config["build"]["cpu"].value_or<std::string>("");
+    if (t.features.empty()) t.features = config["build"]["features"].value_or<std::string>("");
+    return t;
+  }
 
  private:
   // methods
   void createSourceInfo();
   void runPackageManager(bool silent);
+  int linkBinary(std::string objfile, std::string out, bool log, bool removeObject = true);
+  /// @brief Create a llvm builder for the compiled module using the session options.
+  std::unique_ptr<codegen::LLVMBuilder> createBuilder();
 };
 } // namespace snowball
 
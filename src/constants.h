@@ -206,6 +206,11 @@ typedef uint32_t snowball_int_t;
 #error "STATICLIB_DIR path must be defined! (e.g. \"/usr/lib/\")"
 #endif
 
+// LLVM profile runtime linked into instrumented programs (empty if not found)
+#ifndef _SNOWBALL_PROFILE_RT
+#define _SNOWBALL_PROFILE_RT ""
+#endif
+
 #pragma endregion
 
 // Optimizations
@@ -260,6 +265,8 @@ typedef uint32_t snowball_int_t;
 #define _SNOWBALL_KEYWORD__CONSTANT  "const"
 #define _SNOWBALL_KEYWORD__TRY       "try"
 #define _SNOWBALL_KEYWORD__CATCH     "catch"
+#define _SNOWBALL_KEYWORD__ASYNC     "async"
+#define _SNOWBALL_KEYWORD__AWAIT     "await"
 
 #define _SNOWBALL_LAMBDA_FUNCTIONS \
   { 'l', 'a', 'm', 'b', 'd', 'a', ' ', 'f', 'u', 'n', 'c', 't', 'i', 'o', 'n', 0 }
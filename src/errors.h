@@ -80,6 +80,8 @@ class NiceError : public SNError {
   NiceError(Error code, std::string err, DBGSourceInfo* p_cb_dbg_info, ErrorInfo info = {})
     : SNError(code, err), cb_dbg_info(p_cb_dbg_info), info(info) {};
   virtual void print_error(bool asTail = false) const override;
+  /// @return The location in the source code where the error happened
+  DBGSourceInfo* getDBGInfo() const { return cb_dbg_info; }
 };
 
 /**
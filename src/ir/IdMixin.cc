@@ -1,4 +1,3 @@
-
 #include "id.h"
 
 #include <cstdint>
@@ -6,8 +5,17 @@
 namespace snowball {
 namespace ir {
 
-id_t IdMixin::currentId = 0;
-void IdMixin::resetId() { currentId = 0; }
+namespace {
+thread_local IdGenerator fallbackGenerator;
+thread_local IdGenerator* activeGenerator = nullptr;
+} // namespace
+
+IdGenerator::Scope::Scope(IdGenerator& generator) : previous(activeGenerator) { activeGenerator = &generator; }
+IdGenerator::Scope::~Scope() { activeGenerator = previous; }
+
+IdGenerator& IdGenerator::current() { return activeGenerator ? *activeGenerator : fallbackGenerator; }
+
+void IdMixin::resetId() { IdGenerator::current().reset(); }
 
 } // namespace ir
 } // namespace snowball
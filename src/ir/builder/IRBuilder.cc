@@ -41,6 +41,11 @@ SharedValue<Cast> IRBuilder::createCast(DBGSourceInfo* dbgInfo, SharedValue<> va
   setType(cast, type);
   return cast;
 }
+SharedValue<Await> IRBuilder::createAwait(DBGSourceInfo* dbgInfo, SharedValue<> future, Type<> type) {
+  auto await = N<Await>(dbgInfo, future);
+  setType(await, type);
+  return await;
+}
 SharedValue<IndexExtract> IRBuilder::createIndexExtract(
   DBGSourceInfo* dbgInfo, SharedValue<> value, types::DefinedType::ClassField* field, unsigned int index
 ) {
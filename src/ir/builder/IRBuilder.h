@@ -12,6 +12,7 @@
 #include "../values/all.h"
 #include "../values/Switch.h"
 #include "../values/Argument.h"
+#include "../values/Await.h"
 #include "../values/Call.h"
 #include "../values/EnumInit.h"
 #include "../values/Cast.h"
@@ -87,6 +88,8 @@ class IRBuilder : public AcceptorExtend<IRBuilder, ModuleHolder> {
   );
   /// @brief Create a new cast
   SharedValue<Cast> createCast(DBGSourceInfo* dbgInfo, SharedValue<> value, Type<> type);
+  /// @brief Create a new await for a future producing values of type `type`
+  SharedValue<Await> createAwait(DBGSourceInfo* dbgInfo, SharedValue<> future, Type<> type);
   /// @brief Create a new index extract
   SharedValue<IndexExtract> createIndexExtract(
     DBGSourceInfo* dbgInfo, SharedValue<> value, types::DefinedType::ClassField* field, unsigned int index
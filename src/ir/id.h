@@ -1,4 +1,3 @@
-
 #include <cstdint>
 #include <stdio.h>
 
@@ -10,12 +9,49 @@ namespace ir {
 
 using id_t = std::uint64_t;
 
+/**
+ * @brief Generates unique ids for IR nodes.
+ *
+ * Each compilation owns its own generator so that several compilations
+ * can live (and run on different threads) inside the same process
+ * without sharing a counter.
+ */
+class IdGenerator {
+  /// the next id to be given
+  id_t next = 0;
+
+ public:
+  IdGenerator() = default;
+  IdGenerator(const IdGenerator&) = delete;
+  IdGenerator& operator=(const IdGenerator&) = delete;
+
+  /// @return A new unique id for this generator.
+  id_t generate() { return next++; }
+  /// @brief Start counting from zero again.
+  void reset() { next = 0; }
+
+  /**
+   * @brief Makes a generator the active one for the current thread
+   *  until the scope is destroyed.
+   */
+  class Scope {
+    IdGenerator* previous;
+
+   public:
+    explicit Scope(IdGenerator& generator);
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope();
+  };
+
+  /// @return The generator used by the current thread.
+  /// @note If no generator is active, a thread local fallback is used.
+  static IdGenerator& current();
+};
+
 /// Mixin class for IR nodes that need ids.
 class IdMixin {
  private:
-  /// the global id counter
-  static id_t currentId;
-
   IdMixin& operator=(const IdMixin&) = delete;
 
  protected:
@@ -23,11 +59,11 @@ class IdMixin {
   id_t id;
 
  public:
-  /// Resets the global id counter.
+  /// Resets the id counter of the active generator.
   static void resetId();
 
   IdMixin(const IdMixin&) = default;
-  IdMixin() : id(currentId++) { }
+  IdMixin() : id(IdGenerator::current().generate()) { }
 
   /// @return the node's id.
   virtual id_t getId() const { return id; }
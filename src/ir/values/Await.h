@@ -0,0 +1,36 @@
+
+#include "../../ValueVisitor/Visitor.h"
+#include "../../ast/types/Type.h"
+#include "../../common.h"
+#include "Value.h"
+
+#ifndef __SNOWBALL_AWAIT_VALUE_H_
+#define __SNOWBALL_AWAIT_VALUE_H_
+
+namespace snowball {
+namespace ir {
+
+/**
+ * @brief Representation of an await expression in the IR.
+ *  It resumes the awaited coroutine until it finishes, suspending
+ *  the current coroutine every time the awaited one suspends.
+ * @note The type of this value is the type produced by the future.
+ */
+class Await : public AcceptorExtend<Await, Value> {
+  /// @brief Future that's being awaited
+  std::shared_ptr<Value> future = nullptr;
+
+ public:
+  explicit Await(std::shared_ptr<Value> future) : future(future) {};
+
+  /// @return the awaited future
+  auto getFuture() { return future; }
+
+  // Set a visit handler for the generators
+  SN_GENERATOR_VISITS
+};
+
+} // namespace ir
+} // namespace snowball
+
+#endif // __SNOWBALL_AWAIT_VALUE_H_
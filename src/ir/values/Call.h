@@ -51,6 +51,13 @@ class Call : public AcceptorExtend<Call, Value> {
    * @note It's a special variable for the OpType::EQ operator.
    */
   bool isInitialization = false;
+  /**
+   * @brief Whether the call must be generated as a guaranteed tail
+   *  call (`return @tail f(x);`).
+   * @note The code generator reports an error if the call can't be
+   *  a tail call instead of generating a normal one.
+   */
+  bool isTailCall = false;
 };
 
 /**
@@ -110,6 +110,11 @@ class Func : public AcceptorExtend<Func, Value>,
   ///  scope.
   bool _usesParentScope = false;
 
+  /// @brief Type of the value produced by the function if it's a
+  ///  coroutine (an `async` function). Coroutines return a `Future`
+  ///  of this type, so `retTy` can't be used for their returns.
+  types::Type* coroutineResultType = nullptr;
+
   Func(const Func&) = delete;
   Func& operator=(Func const&);
 
@@ -217,6 +222,13 @@ class Func : public AcceptorExtend<Func, Value>,
   /// @return true if the function uses variables from the parent scope.
   auto usesParentScope() const { assert(isAnon()); return _usesParentScope; }
 
+  /// @brief Mark the function as a coroutine producing values of type `x`.
+  void setCoroutineResultType(types::Type* x) { coroutineResultType = x; }
+  /// @return The type of the values returned inside the coroutine.
+  auto getCoroutineResultType() const { assert(isCoroutine()); return coroutineResultType; }
+  /// @return true if the function is a coroutine (declared as `async`).
+  bool isCoroutine() const { return coroutineResultType != nullptr; }
+
   // Set a visit handler for the generators
   SN_GENERATOR_VISITS
  public:
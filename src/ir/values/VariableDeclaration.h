@@ -26,6 +26,8 @@ class VariableDeclaration : public IdMixin, public AcceptorExtend<Variable, Valu
   std::shared_ptr<Value> value;
   // If the variable has been externally declared
   bool external = false;
+  // If every thread gets its own copy of the (global) variable
+  bool threadLocal = false;
 
  protected:
   friend Argument;
@@ -43,6 +45,10 @@ class VariableDeclaration : public IdMixin, public AcceptorExtend<Variable, Valu
   auto getValue() const { return value; }
   /// @return if the variable has been externally declared
   bool isExternDecl() const { return external; }
+  /// @return if every thread gets its own copy of the variable
+  bool isThreadLocal() const { return threadLocal; }
+  /// @brief Give every thread its own copy of the variable
+  void setThreadLocal(bool t = true) { threadLocal = t; }
 
   // Set a visit handler for the generators
   SN_GENERATOR_VISITS
@@ -27,7 +27,7 @@ namespace ir {
  * `WhileLoop` class is used to represent loops in the AST, where the
  * loop condition is checked before each iteration of the loop body.
  */
-class WhileLoop : public AcceptorExtend<WhileLoop, Value> {
+class WhileLoop : public AcceptorExtend<WhileLoop, Value>, public AcceptorExtend<WhileLoop, Syntax::AttributeHolder> {
   // Instructions stored inside a block each iteration
   std::shared_ptr<Block> insts;
   // the expression to be evaluated each iteration
@@ -1,5 +1,6 @@
 
 #include "Argument.h"
+#include "Await.h"
 #include "Body.h"
 #include "Call.h"
 #include "EnumInit.h"
@@ -673,6 +673,10 @@ void Lexer::tokenize() {
             tk.type = TokenType::KWORD_EXTENDS;
           } else if (identifier == _SNOWBALL_KEYWORD__IMPLS) {
             tk.type = TokenType::KWORD_IMPLEMENTS;
+          } else if (identifier == _SNOWBALL_KEYWORD__ASYNC) {
+            tk.type = TokenType::KWORD_ASYNC;
+          } else if (identifier == _SNOWBALL_KEYWORD__AWAIT) {
+            tk.type = TokenType::KWORD_AWAIT;
           } else if (identifier == _SNOWBALL_KEYWORD__TRUE || identifier == _SNOWBALL_KEYWORD__FALSE) {
             tk.type = TokenType::VALUE_BOOL;
           } else {
@@ -703,6 +707,7 @@ void Lexer::tokenize() {
             case TokenType::KWORD_EXTERN:
             case TokenType::KWORD_UNSAFE:
             case TokenType::KWORD_MUTABLE:
+            case TokenType::KWORD_ASYNC:
             case TokenType::IDENTIFIER: // idk about this one
               break;
             default: comments = "";
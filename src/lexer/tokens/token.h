@@ -193,6 +193,8 @@ enum class TokenType {
   KWORD_INTER, // Symbol: interface
   KWORD_EXTENDS, // Symbol: extends
   KWORD_IMPLEMENTS, // Symbol: implements
+  KWORD_ASYNC, // Symbol: async
+  KWORD_AWAIT, // Symbol: await
   KWORD__ENDING__POINT, // All keywords must be less than this
 
   /*
@@ -311,6 +313,8 @@ struct Token {
       case TokenType::KWORD_INTER: return _SNOWBALL_KEYWORD__INTER;
       case TokenType::KWORD_EXTENDS: return _SNOWBALL_KEYWORD__EXTENDS;
       case TokenType::KWORD_IMPLEMENTS: return _SNOWBALL_KEYWORD__IMPLS;
+      case TokenType::KWORD_ASYNC: return _SNOWBALL_KEYWORD__ASYNC;
+      case TokenType::KWORD_AWAIT: return _SNOWBALL_KEYWORD__AWAIT;
       case TokenType::KWORD_CATCH:
         return _SNOWBALL_KEYWORD__CATCH;
       // Literal values
@@ -15,6 +15,7 @@ std::string Driver::getOutputFilename(std::string input, app::Options::EmitType
         output += ".dylib";
       break;
     case app::Options::EmitType::LLVM_IR: output += ".ll"; break;
+    case app::Options::EmitType::LLVM_BC: output += ".bc"; break;
     case app::Options::EmitType::ASSEMBLY: output += ".s"; break;
     case app::Options::EmitType::SNOWBALL_IR: output += ".sir"; break;
   }
@@ -29,6 +30,7 @@ std::string Driver::getOutputFilename(std::string input, app::Options::EmitType
         output += ".so";
       break;
     case app::Options::EmitType::LLVM_IR: output += ".ll"; break;
+    case app::Options::EmitType::LLVM_BC: output += ".bc"; break;
     case app::Options::EmitType::ASSEMBLY: output += ".s"; break;
     case app::Options::EmitType::SNOWBALL_IR: output += ".sir"; break;
   }
@@ -43,6 +45,7 @@ std::string Driver::getOutputFilename(std::string input, app::Options::EmitType
         output += ".dll";
       break;
     case app::Options::EmitType::LLVM_IR: output += ".ll"; break;
+    case app::Options::EmitType::LLVM_BC: output += ".bc"; break;
     case app::Options::EmitType::ASSEMBLY: output += ".s"; break;
     case app::Options::EmitType::SNOWBALL_IR: output += ".sir"; break;
   }
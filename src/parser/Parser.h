@@ -373,6 +373,11 @@ class Parser {
    * @brief Assert that attributes are not accepted in the current context
    */
   void assertNoAttributes(std::string context);
+  /**
+   * @brief Verifies the attributes given to a loop (`@unroll`,
+   *  `@vectorize` and `@no_vectorize`)
+   */
+  std::unordered_map<Attributes, std::unordered_map<std::string, std::string>> verifyLoopAttributes();
 
  private:
   /// @brief Attributes list
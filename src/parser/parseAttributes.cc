@@ -22,7 +22,9 @@ std::unordered_map<std::string, std::unordered_map<std::string, std::string>> Pa
         next();
         if (is<TokenType::BRACKET_RPARENT>()) { break; }
         // TODO: check for already deifned ones
-        auto name = assert_tok<TokenType::IDENTIFIER>("an identifier").to_string();
+        // note: positional numbers are also allowed (e.g. `@unroll(4)`)
+        auto name = is<TokenType::VALUE_NUMBER>() ? m_current.to_string() :
+                    assert_tok<TokenType::IDENTIFIER>("an identifier").to_string();
         next();
         if (is<TokenType::OP_EQ>()) {
           next();
@@ -92,6 +94,19 @@ if (attrType == Attributes::INVALID) {
   return attributes;
 }
 
+std::unordered_map<Attributes, std::unordered_map<std::string, std::string>> Parser::verifyLoopAttributes() {
+  return verifyAttributes([](std::string attr) {
+    if (attr == "unroll") {
+      return Attributes::LOOP_UNROLL;
+    } else if (attr == "vectorize") {
+      return Attributes::LOOP_VECTORIZE;
+    } else if (attr == "no_vectorize") {
+      return Attributes::LOOP_NO_VECTORIZE;
+    }
+    return Attributes::INVALID;
+  });
+}
+
 void Parser::assertNoAttributes(std::string context) {
   if (m_attributes.size() > 0) {
     createError<SYNTAX_ERROR>(FMT("Attributes are not allowed inside a %s", context.c_str()));
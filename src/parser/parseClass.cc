@@ -155,9 +155,9 @@ return Attributes::INVALID;
         }
         if (pk.type != TokenType::KWORD_FUNC &&
             pk.type != TokenType::KWORD_OPERATOR && pk.type != TokenType::KWORD_UNSAFE && (!IS_CONSTRUCTOR(pk))
-            && pk.type != TokenType::KWORD_OVERRIDE) {
+            && pk.type != TokenType::KWORD_OVERRIDE && pk.type != TokenType::KWORD_ASYNC) {
           next();
-          createError<SYNTAX_ERROR>("expected keyword \"func\", \"override\", \"let\", \"operator\", \"unsafe\" or a "
+          createError<SYNTAX_ERROR>("expected keyword \"func\", \"override\", \"let\", \"operator\", \"unsafe\", \"async\" or a "
                                     "constructor "
                                     "declaration after static member");
         }
@@ -180,6 +180,13 @@ return Attributes::INVALID;
                                     "declaration!");
         }
       } break;
+      case TokenType::KWORD_ASYNC: {
+        auto pk = peek();
+        if (pk.type != TokenType::KWORD_FUNC && pk.type != TokenType::KWORD_UNSAFE && pk.type != TokenType::KWORD_MUTABLE) {
+          next();
+          createError<SYNTAX_ERROR>("expected keyword \"func\", \"unsafe\" or \"mut\" after async declaration!");
+        }
+      } break;
       case TokenType::KWORD_FUNC: {
         auto func = parseFunction(false, false, false, isInterface);
         func->setPrivacy(Syntax::Statement::Privacy::fromInt(!inPrivateScope));
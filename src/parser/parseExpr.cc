@@ -20,6 +20,13 @@ Syntax::Expression::Base* Parser::parseExpr(bool allowAssign) {
     auto tk = next();
     Syntax::Expression::Base* expr = nullptr;
     bool parseNormal = false;
+    // note: 'await' applies to the whole postfix expression that follows it,
+    //  e.g. 'await a.b()' awaits the result of the call.
+    DBGSourceInfo* awaitDbg = nullptr;
+    if (TOKEN(KWORD_AWAIT)) {
+      awaitDbg = DBGSourceInfo::fromToken(m_source_info, m_current);
+      tk = next();
+    }
     auto dbg = DBGSourceInfo::fromToken(m_source_info, m_current);
     if (TOKEN(SYM_HASH)) {
       if (TOKEN(SYM_HASH) && is<TokenType::IDENTIFIER>(peek())) {
@@ -119,6 +126,11 @@ Syntax::Expression::Base* Parser::parseExpr(bool allowAssign) {
         expr->setDBGInfo(call->getDBGInfo());
       } else if (TOKEN(OP_NOT) || TOKEN(OP_PLUS) || TOKEN(OP_MINUS) || TOKEN(OP_BIT_NOT) || TOKEN(OP_BIT_AND)
                  || TOKEN(OP_MUL)) {
+        if (awaitDbg) {
+          createError<SYNTAX_ERROR>("Expected a value to await but found an unary operator instead!", {
+            .help = "Wrap the value in parentheses: 'await (...)'"
+          });
+        }
         if (tk.type == TokenType::OP_NOT)
           exprs.push_back(Syntax::N<Syntax::Expression::BinaryOp>(Operators::OperatorType::NOT));
         else if (tk.type == TokenType::OP_PLUS)
@@ -205,6 +217,10 @@ Syntax::Expression::Base* Parser::parseExpr(bool allowAssign) {
         break;
       }
     }
+    if (awaitDbg) {
+      expr = Syntax::N<Syntax::Expression::Await>(expr);
+      expr->setDBGInfo(awaitDbg);
+    }
     bool valid = true;
     exprs.emplace_back(expr);
     services::OperatorService::OperatorType op_type;
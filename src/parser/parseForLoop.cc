@@ -11,6 +11,7 @@ namespace snowball::parser {
 Syntax::Node* Parser::parseForLoop() {
   assert(is<TokenType::KWORD_FOR>());
   auto dbg = DBGSourceInfo::fromToken(m_source_info, m_current);
+  auto attributes = verifyLoopAttributes();
   next(); // Eat "for"
   if (is<TokenType::IDENTIFIER>()) {
     auto var = m_current.to_string();
@@ -25,6 +26,7 @@ Syntax::Node* Parser::parseForLoop() {
       m_inside_loop = backupLoop;
       auto loop = Syntax::N<Syntax::Statement::ForLoop>(var, expr, body);
       loop->setDBGInfo(dbg);
+      for (auto [n, a] : attributes) { loop->addAttribute(n, a); }
       return loop;
     }
     prev();
@@ -57,6 +59,7 @@ Syntax::Node* Parser::parseForLoop() {
   if (!condExpr)
     condExpr = Syntax::N<Syntax::Expression::ConstantValue>(Syntax::Expression::ConstantValue::Bool, "true");
   auto whileLoop = Syntax::N<Syntax::Statement::WhileLoop>(condExpr, body, step);
+  for (auto [n, a] : attributes) { whileLoop->addAttribute(n, a); }
   block.push_back(whileLoop);
   auto loopBlock = Syntax::N<Syntax::Block>(block);
   loopBlock->setDBGInfo(dbg);
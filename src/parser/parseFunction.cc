@@ -30,6 +30,7 @@ FunctionDef* Parser::parseFunction(bool isConstructor, bool isOperator, bool isL
   bool isGeneric = false;
   bool isUnsafe = false;
   bool isOverride = false;
+  bool isAsync = false;
   bool isNotImplemented = false;
   std::string name;
   std::string externName;
@@ -69,6 +70,10 @@ fetch_attrs:
     isOverride = true;
     peekCount--;
     goto fetch_attrs;
+  } else if (is<TokenType::KWORD_ASYNC>(pk)) {
+    isAsync = true;
+    peekCount--;
+    goto fetch_attrs;
   }
   if (isOperator) {
     consume<TokenType::KWORD_FUNC>("'func' keyword");
@@ -76,6 +81,14 @@ fetch_attrs:
   if (isOverride && isStatic) {
     createError<SYNTAX_ERROR>("Static functions can't be overriden!");
   }
+  if (isAsync && (isConstructor || isOperator || isExtern || isVirtual)) {
+    createError<SYNTAX_ERROR>(
+    "Only plain functions and methods can be declared as 'async'!", {
+      .info = "Constructors, operators, external and virtual functions can't be coroutines.",
+      .help = "Move the body to an 'async' function and call it from here."
+    }
+    );
+  }
   auto dbg = m_current.get_pos();
   auto width = 0;
   auto attributes = verifyAttributes([&](std::string attr) {
@@ -106,6 +119,8 @@ fetch_attrs:
     return Attributes::UNSAFE_FUNC_NOT_BODY;
   } else if (attr == "intrinsic") {
     return Attributes::INTRINSIC;
+  } else if (attr == "restrict") {
+    return Attributes::RESTRICT;
   }
 return Attributes::INVALID;
                                    });
@@ -574,6 +589,7 @@ snowballInvalidDefaultOperatorCase:
   if (isNotImplemented) fn->addAttribute(Attributes::NOT_IMPLEMENTED);
   fn->setStatic(isStatic);
   fn->isMutable(isMutable);
+  fn->setAsync(isAsync);
   fn->setComment(comment);
   return fn;
 }
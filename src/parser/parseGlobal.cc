@@ -32,8 +32,8 @@ Parser::NodeVec Parser::parseGlobal(TokenType terminator) {
               && !is<TokenType::KWORD_STRUCT>(pk) &&
               !is<TokenType::KWORD_STATIC>(pk) && !is<TokenType::KWORD_UNSAFE>(pk) && !is<TokenType::KWORD_CLASS>(pk) &&
               !is<TokenType::KWORD_EXTERN>(pk) && !is<TokenType::KWORD_CONST>(pk) && !is<TokenType::KWORD_INTER>(pk) &&
-              !is<TokenType::KWORD_ENUM>(pk)) {
-            createError<SYNTAX_ERROR>("expected keyword \"func\", \"static\", \"unsafe\", \"class\", "
+              !is<TokenType::KWORD_ENUM>(pk) && !is<TokenType::KWORD_ASYNC>(pk)) {
+            createError<SYNTAX_ERROR>("expected keyword \"func\", \"static\", \"unsafe\", \"async\", \"class\", "
                                       "\"let\", \"const\", \"enum\" "
                                       "or "
                                       "\"external\" after public/private declaration");
@@ -54,13 +54,21 @@ Parser::NodeVec Parser::parseGlobal(TokenType terminator) {
         }
         case TokenType::KWORD_STATIC: {
           auto pk = peek();
-          if (!is<TokenType::KWORD_FUNC>(pk) && !is<TokenType::KWORD_UNSAFE>(pk)) {
+          if (!is<TokenType::KWORD_FUNC>(pk) && !is<TokenType::KWORD_UNSAFE>(pk) && !is<TokenType::KWORD_ASYNC>(pk)) {
             next();
-            createError<SYNTAX_ERROR>("expected 'func' or 'unsafe' keyword after a "
+            createError<SYNTAX_ERROR>("expected 'func', 'unsafe' or 'async' keyword after a "
                                       "static function declaration");
           }
           break;
         }
+        case TokenType::KWORD_ASYNC: {
+          auto pk = peek();
+          if (!is<TokenType::KWORD_FUNC>(pk) && !is<TokenType::KWORD_UNSAFE>(pk)) {
+            createError<SYNTAX_ERROR>("expected 'func' or 'unsafe' keyword after an "
+                                      "async function declaration");
+          }
+          break;
+        }
         case TokenType::KWORD_UNSAFE: {
           auto pk = peek();
           if (!is<TokenType::KWORD_FUNC>(pk)) {
@@ -13,9 +13,24 @@ Syntax::Statement::Return* Parser::parseReturn() {
   assert(is<TokenType::KWORD_RETURN>());
   auto info = DBGSourceInfo::fromToken(m_source_info, m_current);
   Syntax::Expression::Base* expr = nullptr;
+  std::unordered_map<Attributes, std::unordered_map<std::string, std::string>> attributes;
+  // e.g. `return @tail fib(n - 1, a + b);`
+  if (is<TokenType::SYM_AT>(peek())) {
+    next();
+    parseAttributes();
+    attributes = verifyAttributes([](std::string attr) {
+      if (attr == "tail") return Attributes::TAIL_CALL;
+      return Attributes::INVALID;
+    });
+    if (auto tail = attributes.find(Attributes::TAIL_CALL); tail != attributes.end() && !tail->second.empty())
+      createError<SYNTAX_ERROR>("Attribute 'tail' does not take any arguments!");
+    if (is<TokenType::SYM_SEMI_COLLON>(peek()))
+      createError<SYNTAX_ERROR>("Expected a function call after '@tail'", {.info = "Only function calls can be tail calls"});
+  }
   if (!is<TokenType::SYM_SEMI_COLLON>(peek())) expr = parseExpr(false);
   auto node = Syntax::N<Return>(expr);
   node->setDBGInfo(info);
+  for (auto [n, a] : attributes) { node->addAttribute(n, a); }
   return node;
 }
 } // namespace snowball::parser
@@ -36,6 +36,11 @@ Syntax::Node* Parser::parseStatement(Token pk) {
       next();
       break;
     }
+    case TokenType::SYM_AT: {
+      next();
+      parseAttributes();
+      return parseStatement(peek());
+    }
     case TokenType::KWORD_BREAK:
     case TokenType::KWORD_CONTINUE: {
       assertNoAttributes("loop control statement");
@@ -64,14 +69,12 @@ Syntax::Node* Parser::parseStatement(Token pk) {
     }
     // TODO: can const be declared at block level in rust?
     case TokenType::KWORD_FOR: {
-      assertNoAttributes("for loop");
       next();
       return parseForLoop();
       break;
     }
     case TokenType::KWORD_WHILE:
     case TokenType::KWORD_DO: {
-      assertNoAttributes("while loop");
       next();
       return parseWhile();
       break;
@@ -12,6 +12,7 @@ Syntax::Statement::VariableDecl* Parser::parseVariable() {
   auto comment = parseDocstring(m_current.getComment());
   next();
   auto attributes = verifyAttributes([&](std::string attr) {
+                                       if (attr == "thread_local") return Attributes::THREAD_LOCAL;
                                        return Attributes::INVALID;
                                      });
   bool isPublic = false;
@@ -13,6 +13,7 @@ namespace snowball::parser {
 WhileLoop* Parser::parseWhile() {
   assert(is<TokenType::KWORD_WHILE>() || is<TokenType::KWORD_DO>());
   auto token = m_current;
+  auto attributes = verifyLoopAttributes();
   bool isDoWhile = is<TokenType::KWORD_DO>(token);
   Syntax::Expression::Base* expr = nullptr;
   Syntax::Block* block = nullptr;
@@ -35,6 +36,7 @@ WhileLoop* Parser::parseWhile() {
   auto v = Syntax::N<Syntax::Statement::WhileLoop>(expr, block, isDoWhile);
   auto info = DBGSourceInfo::fromToken(m_source_info, token);
   v->setDBGInfo(info);
+  for (auto [n, a] : attributes) { v->addAttribute(n, a); }
   return v;
 }
 
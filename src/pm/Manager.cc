@@ -24,7 +24,6 @@ std::string Manager::getGit() {
 
 int Manager::runAsMain() {
   if (!package["dependencies"]) return EXIT_SUCCESS;
-  (void)chdir(((fs::path)configFolder / "deps").c_str());
   // example: "owner/repo" = { version = "1.0.0" }
   auto packages = package["dependencies"].as_table();
   if (package["dependencies"].is_table()) {
@@ -53,7 +52,6 @@ int Manager::runAsMain() {
       }
     }
   }
-  (void)chdir(cwd.c_str());
   return EXIT_SUCCESS;
 }
 
@@ -22,6 +22,14 @@ ImportCache::getModule(fs::path p) {
   return i == modules.end() ? std::nullopt :
          std::make_optional<std::shared_ptr<ir::Module>>(i->second);
 }
+std::vector<fs::path> ImportCache::getPaths() const {
+  std::vector<fs::path> paths;
+  for (auto& [p, _] : modules) paths.push_back(p);
+  return paths;
+}
+void ImportCache::addDependency(fs::path p, fs::path dependency) {
+  dependencies[p.lexically_normal()].insert(dependency.lexically_normal());
+}
 
 // clang-format on
 
@@ -4,6 +4,8 @@
 #include <filesystem>
 #include <map>
 #include <optional>
+#include <set>
+#include <vector>
 
 #ifndef __SNOWBALL_IMPORT_CACHE_H_
 #define __SNOWBALL_IMPORT_CACHE_H_
@@ -19,6 +21,8 @@ class ImportCache {
   /// @brief A map containing the stored modules.
   /// @note The map key is a full abstract path.
   std::map<std::filesystem::path, std::shared_ptr<ir::Module>> modules;
+  /// @brief Files imported directly by each file (the key is the importer).
+  std::map<std::filesystem::path, std::set<std::filesystem::path>> dependencies;
 
  public:
   ImportCache() noexcept = default;
@@ -27,6 +31,14 @@ class ImportCache {
   void addModule(std::filesystem::path p, std::shared_ptr<ir::Module> m);
   /// @return a shared pointer to a module if it exists inside the map
   std::optional<std::shared_ptr<ir::Module>> getModule(std::filesystem::path p);
+  /// @return the paths of all the modules stored in the cache
+  std::vector<std::filesystem::path> getPaths() const;
+  /// @brief Record that the file `p` imports the file `dependency`
+  void addDependency(std::filesystem::path p, std::filesystem::path dependency);
+  /// @return the files imported directly by each file
+  const std::map<std::filesystem::path, std::set<std::filesystem::path>>& getDependencies() const {
+    return dependencies;
+  }
 
   ~ImportCache() noexcept = default;
 };
@@ -16,7 +16,7 @@ fs::path ImportService::getPackagePath(const std::string package) {
   if (package == "std") {
     return (fs::path) utils::get_lib_folder();
   } else if (package == "pkg") {
-    return fs::current_path();
+    return getRootPath();
   }
   return getPackagesPath() / (_SNOWBALL_PACKAGES_DIR) / package;
 }
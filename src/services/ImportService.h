@@ -1,6 +1,7 @@
 
 #include "../common.h"
 #include "ImportCache.h"
+#include "ParseCache.h"
 
 #ifndef __SNOWBALL_SERVICES_IMPORT_H_
 #define __SNOWBALL_SERVICES_IMPORT_H_
@@ -16,6 +17,9 @@ class ImportService {
   /// @brief A cache containing all of the alread-generated modules
   ///  used at compile time.
   ImportCache* cache = new ImportCache();
+  /// @brief Files parsed by previous compilations (if they are kept,
+  ///  see `Compiler::setParseCache`).
+  std::shared_ptr<ParseCache> parseCache = nullptr;
   /// @brief A list of possible pre-defined file extensions used to
   /// search
   ///  if no extension has been defined.
@@ -26,9 +30,13 @@ class ImportService {
   std::filesystem::path currentPackagePath;
   /// @brief Root path to the packages folder
   std::filesystem::path packagesPath;
+  /// @brief Directory of the main file being compiled. "pkg" imports
+  ///  are resolved against it instead of the process working directory.
+  std::filesystem::path rootPath;
 
  public:
-  ImportService(std::filesystem::path packagesPath) : packagesPath(packagesPath) {}
+  ImportService(std::filesystem::path packagesPath, std::filesystem::path rootPath)
+    : packagesPath(packagesPath), rootPath(rootPath) {}
   /**
    * @brief Get the package path based on it's identifier
    * @note if package name is "pkg" it will return the current package
@@ -80,6 +88,10 @@ class ImportService {
    * @brief Get the packages path
    */
   std::filesystem::path getPackagesPath() const { return packagesPath; }
+  /**
+   * @brief Get the directory of the main file being compiled
+   */
+  std::filesystem::path getRootPath() const { return rootPath; }
 };
 
 } // namespace services
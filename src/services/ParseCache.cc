@@ -0,0 +1,22 @@
+
+#include "ParseCache.h"
+
+namespace fs = std::filesystem;
+
+namespace snowball {
+namespace services {
+
+std::optional<ParseCache::Entry> ParseCache::get(fs::path p, const std::string& content) const {
+  auto i = entries.find(p.lexically_normal());
+  if (i == entries.end() || i->second.srcInfo->getSource() != content) return std::nullopt;
+  return i->second;
+}
+
+void ParseCache::set(fs::path p, const SourceInfo* srcInfo, std::vector<Syntax::Node*> ast) {
+  entries[p.lexically_normal()] = {srcInfo, ast};
+}
+
+void ParseCache::invalidate(fs::path p) { entries.erase(p.lexically_normal()); }
+
+} // namespace services
+} // namespace snowball
@@ -0,0 +1,52 @@
+#include "../SourceInfo.h"
+#include "../ast/syntax/common.h"
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifndef __SNOWBALL_PARSE_CACHE_H_
+#define __SNOWBALL_PARSE_CACHE_H_
+
+namespace snowball {
+namespace services {
+
+/**
+ * @brief Parsed files kept between compilations of the same project.
+ *
+ * Lexing and parsing a file only depend on its contents, so a resident
+ * compiler (`snowball build --watch`) gives the same cache to every new
+ * session and only the files that changed since the last build are parsed
+ * again.
+ */
+class ParseCache {
+ public:
+  struct Entry {
+    /// @brief Source info the nodes point to (it holds the parsed contents)
+    const SourceInfo* srcInfo;
+    std::vector<Syntax::Node*> ast;
+  };
+
+ private:
+  /// @note The map key is a full abstract path.
+  std::map<std::filesystem::path, Entry> entries;
+
+ public:
+  ParseCache() noexcept = default;
+
+  /// @return the parsed file if it was parsed with these exact contents
+  std::optional<Entry> get(std::filesystem::path p, const std::string& content) const;
+  /// @brief Store the result of parsing a file
+  void set(std::filesystem::path p, const SourceInfo* srcInfo, std::vector<Syntax::Node*> ast);
+  /// @brief Forget a file, it will be parsed again the next time it's used
+  void invalidate(std::filesystem::path p);
+
+  ~ParseCache() noexcept = default;
+};
+
+} // namespace services
+} // namespace snowball
+
+#endif // __SNOWBALL_PARSE_CACHE_H_
@@ -85,6 +85,8 @@ class TransformContext : public AcceptorExtend<TransformContext, ASTContext<tran
   TransformContext(
     std::shared_ptr<ir::Module> mod,
     ir::IRBuilder builder,
+    std::filesystem::path packagesPath,
+    std::filesystem::path rootPath,
     bool testMode = false, bool benchMode = false,
     bool silentOutput = false
   );
@@ -28,10 +28,15 @@ namespace snowball {
 namespace Syntax {
 
 Transformer::Transformer(std::shared_ptr<ir::Module> mod, const SourceInfo* srci, std::filesystem::path packagePath,
-                         bool allowTests, bool allowBenchmarks, bool silentOutput)
+                         std::filesystem::path projectPath, bool allowTests, bool allowBenchmarks, bool silentOutput,
+                         std::shared_ptr<services::ParseCache> parseCache)
   : AcceptorExtend<Transformer, Visitor>(srci) {
-  ctx = new TransformContext(mod, ir::IRBuilder(mod), allowTests, allowBenchmarks, silentOutput);
+  ctx = new TransformContext(
+    mod, ir::IRBuilder(mod), projectPath, packagePath, allowTests, allowBenchmarks, silentOutput
+  );
   ctx->imports->setCurrentPackagePath(packagePath);
+  // note: it has to be set before the core library gets imported
+  ctx->imports->parseCache = parseCache;
   initializeCoreRuntime();
 }
 
@@ -67,6 +72,11 @@ std::shared_ptr<ir::Value> Transformer::trans(Node* node) {
 }
 
 std::vector<std::shared_ptr<ir::Module>> Transformer::getModules() const { return modules; }
+std::vector<std::filesystem::path> Transformer::getImportedPaths() const { return ctx->imports->cache->getPaths(); }
+Cache* Transformer::getCache() const { return ctx->cache; }
+const std::map<std::filesystem::path, std::set<std::filesystem::path>>& Transformer::getImportDependencies() const {
+  return ctx->imports->cache->getDependencies();
+}
 void Transformer::addModule(std::shared_ptr<ir::Module> m) {
   ctx->cache->addModule(m->getUniqueName(), m);
   modules.push_back(m);
@@ -23,11 +23,15 @@
 #include "../ir/values/ValueExtract.h"
 #include "../ir/values/Switch.h"
 #include "../ir/values/all.h"
+#include "../services/ParseCache.h"
 #include "../utils/utils.h"
 
 #include <assert.h>
 #include <deque>
+#include <filesystem>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -524,8 +528,9 @@ class Transformer : public AcceptorExtend<Transformer, Visitor> {
 
  public:
   Transformer(
-    std::shared_ptr<ir::Module> mod, const SourceInfo* srci, std::filesystem::path packagePath, bool allowTests = false,
-    bool allowBenchmark = false, bool silentOutput = false
+    std::shared_ptr<ir::Module> mod, const SourceInfo* srci, std::filesystem::path packagePath,
+    std::filesystem::path projectPath, bool allowTests = false, bool allowBenchmark = false, bool silentOutput = false,
+    std::shared_ptr<services::ParseCache> parseCache = nullptr
   );
 
   using AcceptorExtend<Transformer, Visitor>::visit;
@@ -557,6 +562,12 @@ class Transformer : public AcceptorExtend<Transformer, Visitor> {
   );
   /// @return a list of generated modules through the whole project
   std::vector<std::shared_ptr<ir::Module>> getModules() const;
+  /// @return the paths of every file imported while transforming the project
+  std::vector<std::filesystem::path> getImportedPaths() const;
+  /// @return the cache used while transforming the project
+  Cache* getCache() const;
+  /// @return the files imported directly by each file of the project
+  const std::map<std::filesystem::path, std::set<std::filesystem::path>>& getImportDependencies() const;
 
 #include "../defs/accepts.def"
 
@@ -312,6 +312,11 @@ VISIT(Conditional) {
 
 VISIT(LoopFlow) { /* noop */ }
 
+VISIT(Await) {
+  assert(ctx->getCurrentFunction()->isCoroutine());
+  p_node->getFuture()->visit(this);
+}
+
 VISIT(Cast) {
   auto v = p_node->getExpr();
   auto t = p_node->getCastType();
@@ -397,7 +402,9 @@ VISIT(Return) {
   auto fn = ctx->getCurrentFunction();
   assert(fn != nullptr);
   if (p_node->getExpr() != nullptr) p_node->getExpr()->visit(this);
-  if ((utils::cast<types::VoidType>(fn->getRetTy()) != nullptr) && (p_node->getExpr() != nullptr)) {
+  // note: returns inside coroutines produce the value of their future
+  auto retTy = fn->isCoroutine() ? fn->getCoroutineResultType() : fn->getRetTy();
+  if ((utils::cast<types::VoidType>(retTy) != nullptr) && (p_node->getExpr() != nullptr)) {
     E<TYPE_ERROR>(
       p_node,
       FMT("Nonvalue returning function cant have a "
@@ -405,21 +412,21 @@ VISIT(Return) {
           p_node->getType()->getPrettyName().c_str())
     );
   }
-  if ((utils::cast<types::VoidType>(fn->getRetTy()) == nullptr) && (p_node->getExpr() == nullptr)) {
+  if ((utils::cast<types::VoidType>(retTy) == nullptr) && (p_node->getExpr() == nullptr)) {
     E<TYPE_ERROR>(
       p_node,
       FMT("Cant return \"nothing\" in a function with "
           "non-void return type (%s)!",
-          fn->getRetTy()->getPrettyName().c_str())
+          retTy->getPrettyName().c_str())
     );
   }
-  if (!p_node->getType()->is(fn->getRetTy())) {
+  if (!p_node->getType()->is(retTy)) {
     E<TYPE_ERROR>(
       p_node,
       FMT("Return type ('%s') does not match parent "
           "function return type ('%s')!",
           p_node->getType()->getPrettyName().c_str(),
-          fn->getRetTy()->getPrettyName().c_str())
+          retTy->getPrettyName().c_str())
     );
   }
 }
@@ -13,6 +13,7 @@ SN_DEFINITE_ASSIGMENT_VISIT(Expression::NewInstance) {
 }
 
 SN_DEFINITE_ASSIGMENT_VISIT(Expression::Cast) { p_node->getValue()->accept(this); }
+SN_DEFINITE_ASSIGMENT_VISIT(Expression::Await) { p_node->getValue()->accept(this); }
 SN_DEFINITE_ASSIGMENT_VISIT(Expression::GenericIdentifier) {
   utils::cast<Expression::Identifier>(p_node)->accept(this);
 }
@@ -18,6 +18,7 @@ SN_DOCGEN_VISIT(Expression::GenericIdentifier) {}
 SN_DOCGEN_VISIT(Expression::Index) {}
 SN_DOCGEN_VISIT(Expression::TypeRef) {}
 SN_DOCGEN_VISIT(Expression::Cast) {}
+SN_DOCGEN_VISIT(Expression::Await) {}
 SN_DOCGEN_VISIT(Expression::NewInstance) {}
 SN_DOCGEN_VISIT(Expression::BinaryOp) {}
 SN_DOCGEN_VISIT(Expression::LambdaFunction) {}
@@ -42,6 +42,26 @@ std::shared_ptr<ir::Func> Transformer::transformFunction(
                                     auto returnType = transformSizedType(
                                         node->getRetType(), true, "Function return type must be sized but found '%s' (which is not sized)"
                                       );
+                                    // Async functions are coroutines that return a future of
+                                    // their declared return type.
+                                    auto functionReturnType = returnType;
+                                    if (node->isAsync()) {
+                                      if (bodiedFn == nullptr || node->hasAttribute(Attributes::LLVM_FUNC)) {
+                                        E<SYNTAX_ERROR>(node, "Only functions with a body can be declared as 'async'!", {
+                                          .info = "Coroutines need a body to be split at their suspension points"
+                                        });
+                                      }
+                                      if (isEntryPoint) {
+                                        E<SYNTAX_ERROR>(node, "The entry point can't be declared as 'async'!", {
+                                          .help = "Run the coroutine from 'main' with 'coro::block_on' instead"
+                                        });
+                                      }
+                                      auto futureIdentifier = N<Expression::GenericIdentifier>(
+                                          "Future", std::vector<Expression::TypeRef*> {returnType->toRef()});
+                                      auto coreIdentifier = N<Expression::Identifier>("std");
+                                      auto futureRefNode = N<Expression::Index>(coreIdentifier, futureIdentifier, true);
+                                      functionReturnType = transformType(TR(futureRefNode, "std::Future", node->getDBGInfo(), ""));
+                                    }
                                     // Create a new function value and store it's return type.
                                     fn = getBuilder().createFunction(
                                         node->getDBGInfo(),
@@ -51,7 +71,8 @@ std::shared_ptr<ir::Func> Transformer::transformFunction(
                                          );
                                     fn->setScopeIndex(ctx->getScopeIndex());
                                     fn->setParent(ctx->getCurrentClass());
-                                    fn->setRetTy(returnType);
+                                    fn->setRetTy(functionReturnType);
+                                    if (node->isAsync()) fn->setCoroutineResultType(returnType);
                                     fn->setPrivacy(node->getPrivacy());
                                     fn->setStatic(node->isStatic());
                                     if (node->isGeneric()) fn->setGenerics(fnGenerics);
@@ -92,6 +113,22 @@ std::shared_ptr<ir::Func> Transformer::transformFunction(
     newArgs.push_back({arg->getName(), a});
   }
   fn->setArgs(newArgs);
+  if (fn->hasAttribute(Attributes::RESTRICT)) {
+    for (auto [argName, value] : fn->getAttributeArgs(Attributes::RESTRICT)) {
+      auto arg = std::find_if(newArgs.begin(), newArgs.end(), [&](auto& a) { return a.first == argName; });
+      if (arg == newArgs.end() || !value.empty()) {
+        E<ATTRIBUTE_ERROR>(node, FMT("Function '%s' has no argument named '%s' to restrict!", name.c_str(), argName.c_str()), {
+          .help = "Use '@restrict' to restrict every pointer argument or '@restrict(a, b)' to only restrict 'a' and 'b'."
+        });
+      }
+      auto type = arg->second->getType();
+      if (!is<types::ReferenceType>(type) && !is<types::PointerType>(type)) {
+        E<ATTRIBUTE_ERROR>(node, FMT("Argument '%s' can't be restricted because it's not a pointer or a reference!", argName.c_str()), {
+          .info = FMT("Argument has type '%s'", type->getPrettyName().c_str())
+        });
+      }
+    }
+  }
   auto fnType = types::FunctionType::from(fn.get(), node);
                 fn->setType(fnType);
   if (auto x = shouldReturnOverload(fn, overloads)) {
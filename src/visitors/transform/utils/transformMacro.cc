@@ -128,12 +128,14 @@ void Transformer::transformMacro(Expression::PseudoVariable* p_node, MacroInstan
     auto filename = str->getValue();
     // remove the quotes from the string
     filename = filename.substr(1, filename.size() - 2);
+    // relative paths are resolved from the main file's directory
+    auto rootPath = ctx->imports->getRootPath();
     std::ifstream myfile;
-    myfile.open(filename);
+    myfile.open(rootPath / filename);
     if (!myfile.is_open()) {
       E<PSEUDO_ERROR>(p_node, FMT("Could not find file '%s'!", filename.c_str()), {
         .info = "This is the file that was tried to be included",
-        .note = "cwd: '" + std::filesystem::current_path().string() + "'",
+        .note = "cwd: '" + rootPath.string() + "'",
       });
     }
     std::string strValue((std::istreambuf_iterator<char>(myfile)), std::istreambuf_iterator<char>());
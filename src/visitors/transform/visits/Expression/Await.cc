@@ -0,0 +1,36 @@
+#include "../../../../ir/values/Await.h"
+
+#include "../../../Transformer.h"
+
+using namespace snowball::utils;
+using namespace snowball::Syntax::transform;
+
+namespace snowball {
+namespace Syntax {
+
+SN_TRANSFORMER_VISIT(Expression::Await) {
+  auto fn = ctx->getCurrentFunction();
+  if (fn == nullptr || !fn->isCoroutine()) {
+    E<SYNTAX_ERROR>(
+      p_node,
+      "'await' can only be used inside async functions!",
+      {.info = "The current function is not a coroutine",
+       .help = "Declare the function as 'async' or run the future with 'coro::block_on'"}
+    );
+  }
+  auto future = trans(p_node->getValue());
+  auto type = utils::cast<types::DefinedType>(future->getType());
+  if (type == nullptr || !utils::startsWith(type->getUUID(), services::ImportService::CORE_UUID + "std.Future")) {
+    E<TYPE_ERROR>(
+      p_node,
+      FMT("Cant await a value of type '%s'!", future->getType()->getPrettyName().c_str()),
+      {.info = "Only futures can be awaited",
+       .help = "Values returned by async functions have the type 'Future<T>'"}
+    );
+  }
+  auto v = getBuilder().createAwait(p_node->getDBGInfo(), future, type->getGenerics().at(0));
+  this->value = v;
+}
+
+} // namespace Syntax
+} // namespace snowball
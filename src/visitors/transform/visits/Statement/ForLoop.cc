@@ -65,6 +65,7 @@ SN_TRANSFORMER_VISIT(Statement::ForLoop) {
   auto stmts = block->getStmts();
   stmts.insert(stmts.begin(), iterValue);
   auto whileLoop = Syntax::N<Syntax::Statement::WhileLoop>(validCall, Syntax::N<Syntax::Block>(stmts), eq);
+  whileLoop->setAttributes(p_node);
   auto resetIdent = Syntax::N<Syntax::Expression::Identifier>("reset");
   auto resetIndex =
     Syntax::N<Syntax::Expression::Index>(Syntax::N<Syntax::Expression::Identifier>(iterName), resetIdent);
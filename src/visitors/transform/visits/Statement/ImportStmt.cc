@@ -49,6 +49,7 @@ SN_TRANSFORMER_VISIT(Statement::ImportStmt) {
     "keyword to give it a different name."
   }
   );
+  ctx->imports->cache->addDependency(getSourceInfo()->getPath(), filePath);
   if (auto m = ctx->imports->cache->getModule(filePath)) {
     importedModule = m.value();
     auto item = std::make_shared<Item>(std::move(m.value()));
@@ -70,31 +71,43 @@ SN_TRANSFORMER_VISIT(Statement::ImportStmt) {
                      assert(!ifs.fail());
                      std::string content((std::istreambuf_iterator<char>(ifs)),
                                          (std::istreambuf_iterator<char>()));
-                     const SourceInfo* srcInfo = new SourceInfo(content, filePath);
+    auto parseCache = ctx->imports->parseCache;
+    auto cached = parseCache ? parseCache->get(filePath, content) : std::nullopt;
+    const SourceInfo* srcInfo = cached ? cached->srcInfo : new SourceInfo(content, filePath);
     auto backupSourceInfo = getSourceInfo();
     setSourceInfo(srcInfo);
     SHOW_STATUS(Logger::compiling(Logger::progress(0.20, niceFullName)))
 
-    Lexer lexer(srcInfo);
+    std::vector<Node*> ast;
+    bool parsed = cached.has_value();
+    if (cached) {
+      // note: the file didn't change since a previous compilation parsed it
+      ast = cached->ast;
+    } else {
+      Lexer lexer(srcInfo);
 #if _SNOWBALL_TIMERS_DEBUG
-    DEBUG_TIMER("Lexer: %fs (%s)", utils::_timer([&] {
-                  lexer.tokenize();
-                }), filePath.c_str());
+      DEBUG_TIMER("Lexer: %fs (%s)", utils::_timer([&] {
+                    lexer.tokenize();
+                  }), filePath.c_str());
 #else
-    lexer.tokenize();
+      lexer.tokenize();
 #endif
-    auto tokens = lexer.tokens;
-    if (tokens.size() != 0) {
-    auto backupModule = ctx->module;
-    ctx->module = mod;
-    SHOW_STATUS(Logger::compiling(Logger::progress(0.40, niceFullName)))
-      parser::Parser parser(tokens, srcInfo);
+      auto tokens = lexer.tokens;
+      if (tokens.size() != 0) {
+        SHOW_STATUS(Logger::compiling(Logger::progress(0.40, niceFullName)))
+        parser::Parser parser(tokens, srcInfo);
 #if _SNOWBALL_TIMERS_DEBUG
-      parser::Parser::NodeVec ast;
-      DEBUG_TIMER("Parser: %fs (%s)", utils::_timer([&] { ast = parser.parse(); }), filePath.c_str());
+        DEBUG_TIMER("Parser: %fs (%s)", utils::_timer([&] { ast = parser.parse(); }), filePath.c_str());
 #else
-      auto ast = parser.parse();
+        ast = parser.parse();
 #endif
+        parsed = true;
+        if (parseCache) parseCache->set(filePath, srcInfo, ast);
+      }
+    }
+    if (parsed) {
+    auto backupModule = ctx->module;
+    ctx->module = mod;
       SHOW_STATUS(Logger::compiling(Logger::progress(0.55, niceFullName)))
       ctx->module->setSourceInfo(srcInfo);
       visitGlobal(ast);
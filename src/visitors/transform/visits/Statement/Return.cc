@@ -6,6 +6,35 @@ using namespace snowball::Syntax::transform;
 namespace snowball {
 namespace Syntax {
 
+namespace {
+/**
+ * @brief Mark the value returned by `return @tail ...` as a guaranteed tail call.
+ * @note Only the checks that can be done with the snowball types are made
+ *  here, the rest (e.g. matching signatures) are done by the code generator.
+ */
+void markTailCall(Statement::Return* node, std::shared_ptr<ir::Value> value, types::Type* retType) {
+  auto call = utils::dyn_cast<ir::Call>(value);
+  if (!call || utils::is<ir::ObjectInitialization>(call.get()) || utils::is<ir::EnumInit>(call->getCallee().get())) {
+    E<SYNTAX_ERROR>(
+      node,
+      "Only function calls can be tail calls!",
+      {.info = "This value is not a function call",
+       .help = "Remove the '@tail' attribute or return a function call instead"}
+    );
+  }
+  if (!value->getType()->is(retType)) {
+    E<TYPE_ERROR>(
+      node,
+      "The tail called function must return the same type as the current function!",
+      {.info = FMT("The called function returns '%s' but the current function returns '%s'",
+                   value->getType()->getPrettyName().c_str(), retType->getPrettyName().c_str()),
+       .help = "Guaranteed tail calls can't convert or discard the returned value"}
+    );
+  }
+  call->isTailCall = true;
+}
+} // namespace
+
 SN_TRANSFORMER_VISIT(Statement::Return) {
   auto functionType = getFunctionType(ctx->getCurrentFunction()->getType());
   assert(functionType);
@@ -17,11 +46,29 @@ SN_TRANSFORMER_VISIT(Statement::Return) {
     );
   }
   std::shared_ptr<ir::Value> ret = nullptr;
-  if (!utils::cast<types::VoidType>(functionType->getRetType())) {
+  bool isTailCall = p_node->hasAttribute(Attributes::TAIL_CALL);
+  // Coroutines return a future, but their return statements take the value it produces
+  auto retType = functionType->getRetType();
+  if (auto f = ctx->getCurrentFunction(); f->isCoroutine()) {
+    retType = f->getCoroutineResultType();
+    if (isTailCall) {
+      E<SYNTAX_ERROR>(
+        p_node,
+        "Async functions can't contain tail calls!",
+        {.info = "Returning from a coroutine suspends it instead of leaving its frame",
+         .help = "Remove the '@tail' attribute"}
+      );
+    }
+  }
+  if (!utils::cast<types::VoidType>(retType)) {
     std::shared_ptr<ir::Value> returnValue = nullptr;
     if (p_node->getValue() != nullptr) {
       returnValue = trans(p_node->getValue());
-      if (auto cast = tryCast(returnValue, functionType->getRetType()); cast != nullptr) returnValue = cast;
+      if (isTailCall) {
+        markTailCall(p_node, returnValue, retType);
+      } else if (auto cast = tryCast(returnValue, retType); cast != nullptr) {
+        returnValue = cast;
+      }
     } else {
       E<SYNTAX_ERROR>(
         p_node,
@@ -30,6 +77,12 @@ SN_TRANSFORMER_VISIT(Statement::Return) {
       );
     }
     ret = getBuilder().createReturn(p_node->getDBGInfo(), returnValue);
+  } else if (isTailCall) {
+    // Void functions can also end with a tail call (e.g. `return @tail visit(node.left);`)
+    auto returnValue = trans(p_node->getValue());
+    markTailCall(p_node, returnValue, retType);
+    ret = getBuilder().createReturn(p_node->getDBGInfo(), returnValue);
+    ret->setType(ctx->getVoidType());
   } else {
     if (p_node->getValue() != nullptr) {
       E<SYNTAX_ERROR>(
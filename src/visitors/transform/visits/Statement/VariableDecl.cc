@@ -1,4 +1,5 @@
 #include "../../../../ir/values/Cast.h"
+#include "../../../../ir/values/Constants.h"
 #include "../../../Transformer.h"
 
 using namespace snowball::utils;
@@ -14,7 +15,13 @@ SN_TRANSFORMER_VISIT(Statement::VariableDecl) {
   auto variableName = p_node->getName();
   auto variableValue = p_node->getValue();
   auto isMutable = p_node->isMutable();
+  auto isThreadLocal = p_node->hasAttribute(Attributes::THREAD_LOCAL);
   assert(p_node->isInitialized() || definedType != nullptr);
+  if (isThreadLocal && (ctx->getCurrentFunction() || ctx->getCurrentClass())) {
+    E<ATTRIBUTE_ERROR>(p_node, "Attribute 'thread_local' can only be used on global variables!", {
+      .help = "Local variables already belong to the thread running the function."
+    });
+  }
   if (definedType) {
     // definedType = utils::copy_shared(definedType);
     definedType->setMutable(isMutable);
@@ -48,8 +55,18 @@ SN_TRANSFORMER_VISIT(Statement::VariableDecl) {
   // TODO: it should always be declared
   if (p_node->isInitialized()) {
     auto val = trans(variableValue);
+    if (isThreadLocal && !utils::is<ir::ConstantValue>(val.get())) {
+      E<ATTRIBUTE_ERROR>(p_node, "Thread-local variables must be initialized with a constant value!", {
+        .info = "This value is computed when the program starts",
+        .note = "Global initializers only run on the main thread, other threads\n"
+        "would see an uninitialized copy of the variable.",
+        .help = "Initialize the variable with a literal and assign the computed\n"
+        "value from the thread that uses it."
+      });
+    }
     auto varDecl = getBuilder().createVariableDeclaration(p_node->getDBGInfo(), var, val, p_node->isExternDecl());
     varDecl->setId(var->getId());
+    varDecl->setThreadLocal(isThreadLocal);
     getBuilder().setType(varDecl, val->getType());
     if (auto f = ctx->getCurrentFunction().get()) {
       f->addSymbol(varDecl);
@@ -78,6 +95,7 @@ SN_TRANSFORMER_VISIT(Statement::VariableDecl) {
   } else {
     auto varDecl = getBuilder().createVariableDeclaration(p_node->getDBGInfo(), var, nullptr, p_node->isExternDecl());
     varDecl->setId(var->getId());
+    varDecl->setThreadLocal(isThreadLocal);
     getBuilder().setType(varDecl, definedType);
     if (auto f = ctx->getCurrentFunction().get()) {
       f->addSymbol(varDecl);
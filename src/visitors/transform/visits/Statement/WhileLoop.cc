@@ -8,7 +8,38 @@ using namespace snowball::Syntax::transform;
 namespace snowball {
 namespace Syntax {
 
+namespace {
+/// @return Whether the string is a strictly positive integer
+bool isPositive(const std::string& s) { return isNumber(s) && s.size() < 10 && std::stoi(s) > 0; }
+} // namespace
+
 SN_TRANSFORMER_VISIT(Statement::WhileLoop) {
+  if (p_node->hasAttribute(Attributes::LOOP_UNROLL)) {
+    auto args = p_node->getAttributeArgs(Attributes::LOOP_UNROLL);
+    if (args.size() > 1 || (args.size() == 1 && (!isPositive(args.begin()->first) || !args.begin()->second.empty()))) {
+      E<ATTRIBUTE_ERROR>(p_node, "Attribute 'unroll' only takes an optional positive unroll count!", {
+        .help = "Use '@unroll' to let the optimizer pick the count or '@unroll(4)' to unroll 4 times."
+      });
+    }
+  }
+  if (p_node->hasAttribute(Attributes::LOOP_VECTORIZE)) {
+    for (auto [name, value] : p_node->getAttributeArgs(Attributes::LOOP_VECTORIZE)) {
+      if (name != "width" && name != "interleave") {
+        E<ATTRIBUTE_ERROR>(p_node, FMT("Unknown argument '%s' for attribute 'vectorize'!", name.c_str()), {
+          .help = "The supported arguments are 'width' and 'interleave' (e.g. '@vectorize(width = 4)')."
+        });
+      } else if (!isPositive(value)) {
+        E<ATTRIBUTE_ERROR>(p_node, FMT("Argument '%s' for attribute 'vectorize' must be a positive integer!", name.c_str()));
+      }
+    }
+  }
+  if (p_node->hasAttribute(Attributes::LOOP_NO_VECTORIZE)) {
+    if (p_node->hasAttribute(Attributes::LOOP_VECTORIZE)) {
+      E<ATTRIBUTE_ERROR>(p_node, "Attributes 'vectorize' and 'no_vectorize' can't be used on the same loop!");
+    } else if (!p_node->getAttributeArgs(Attributes::LOOP_NO_VECTORIZE).empty()) {
+      E<ATTRIBUTE_ERROR>(p_node, "Attribute 'no_vectorize' does not take any arguments!");
+    }
+  }
   auto cond = trans(p_node->getCondition());
   auto expr = getBooleanValue(cond);
   auto block = trans(p_node->getBlock());
@@ -19,6 +50,7 @@ SN_TRANSFORMER_VISIT(Statement::WhileLoop) {
   } else {
     loop = getBuilder().createWhileLoop(p_node->getDBGInfo(), expr, body, p_node->isDoWhile());
   }
+  loop->setAttributes(p_node);
   this->value = utils::dyn_cast<ir::Value>(loop);
 }
 